@@ -34,12 +34,35 @@
 #define ANKERL_UNORDERED_DENSE_VERSION_MINOR 0 // NOLINT(cppcoreguidelines-macro-usage) backwards compatible functionality
 #define ANKERL_UNORDERED_DENSE_VERSION_PATCH 2 // NOLINT(cppcoreguidelines-macro-usage) backwards compatible bug fixes
 
+// Opt-in operation counters in the hot paths, see table_counters. Off by default, then they compile away completely.
+#ifndef ANKERL_UNORDERED_DENSE_STATS
+#    define ANKERL_UNORDERED_DENSE_STATS 0 // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+
 // API versioning with inline namespace, see https://www.foonathan.net/2018/11/inline-namespaces/
-#define ANKERL_UNORDERED_DENSE_VERSION_CONCAT1(major, minor, patch) v##major##_##minor##_##patch
-#define ANKERL_UNORDERED_DENSE_VERSION_CONCAT(major, minor, patch) ANKERL_UNORDERED_DENSE_VERSION_CONCAT1(major, minor, patch)
-#define ANKERL_UNORDERED_DENSE_NAMESPACE   \
-    ANKERL_UNORDERED_DENSE_VERSION_CONCAT( \
-        ANKERL_UNORDERED_DENSE_VERSION_MAJOR, ANKERL_UNORDERED_DENSE_VERSION_MINOR, ANKERL_UNORDERED_DENSE_VERSION_PATCH)
+// With ANKERL_UNORDERED_DENSE_STATS the table has a different layout, and with ANKERL_UNORDERED_DENSE_X86_DISPATCH
+// hash_aes gives different hashes. Both get a different namespace, so translation units that disagree on them don't share
+// inline functions. They can be linked together, but passing a map from one to the other fails to link.
+#if ANKERL_UNORDERED_DENSE_STATS
+#    define ANKERL_UNORDERED_DENSE_STATS_SUFFIX _stats // NOLINT(cppcoreguidelines-macro-usage)
+#else
+#    define ANKERL_UNORDERED_DENSE_STATS_SUFFIX // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+#if defined(ANKERL_UNORDERED_DENSE_X86_DISPATCH)
+#    define ANKERL_UNORDERED_DENSE_DISPATCH_SUFFIX _x86 // NOLINT(cppcoreguidelines-macro-usage)
+#else
+#    define ANKERL_UNORDERED_DENSE_DISPATCH_SUFFIX // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+#define ANKERL_UNORDERED_DENSE_VERSION_CONCAT1(major, minor, patch, stats, dispatch) \
+    v##major##_##minor##_##patch##stats##dispatch
+#define ANKERL_UNORDERED_DENSE_VERSION_CONCAT(major, minor, patch, stats, dispatch) \
+    ANKERL_UNORDERED_DENSE_VERSION_CONCAT1(major, minor, patch, stats, dispatch)
+#define ANKERL_UNORDERED_DENSE_NAMESPACE                                                                                      \
+    ANKERL_UNORDERED_DENSE_VERSION_CONCAT(ANKERL_UNORDERED_DENSE_VERSION_MAJOR,                                               \
+                                          ANKERL_UNORDERED_DENSE_VERSION_MINOR,                                               \
+                                          ANKERL_UNORDERED_DENSE_VERSION_PATCH,                                               \
+                                          ANKERL_UNORDERED_DENSE_STATS_SUFFIX,                                                \
+                                          ANKERL_UNORDERED_DENSE_DISPATCH_SUFFIX)
 
 #if defined(_MSVC_LANG)
 #    define ANKERL_UNORDERED_DENSE_CPP_VERSION _MSVC_LANG
@@ -59,6 +82,10 @@
 #    error ankerl::unordered_dense requires C++17 or higher
 #else
 #    include <array>            // for array
+#    include <chrono>           // for steady_clock, nanoseconds
+#    include <climits>          // for CHAR_BIT
+#    include <cmath>            // for isnan
+#    include <cstddef>          // for ptrdiff_t
 #    include <cstdint>          // for uint64_t, uint32_t, uint8_t, UINT64_C
 #    include <cstring>          // for size_t, memcpy, memset
 #    include <functional>       // for equal_to, hash
@@ -66,14 +93,20 @@
 #    include <iterator>         // for pair, distance
 #    include <limits>           // for numeric_limits
 #    include <memory>           // for allocator, allocator_traits, shared_ptr
-#    include <stdexcept>        // for out_of_range
+#    include <new>              // for placement new
+#    include <optional>         // for optional
+#    include <stdexcept>        // for out_of_range, length_error
 #    include <string>           // for basic_string
 #    include <string_view>      // for basic_string_view, hash
-#    include <tuple>            // for forward_as_tuple
+#    include <tuple>            // for forward_as_tuple, tuple, apply
 #    include <type_traits>      // for enable_if_t, declval, conditional_t, ena...
 #    include <utility>          // for forward, exchange, pair, as_const, piece...
 #    include <vector>           // for vector
 
+#    if ANKERL_UNORDERED_DENSE_STATS
+#        include <atomic> // for atomic, memory_order_relaxed
+#    endif
+
 #    define ANKERL_UNORDERED_DENSE_PMR 0 // NOLINT(cppcoreguidelines-macro-usage)
 #    if defined(__has_include)
 #        if __has_include(<memory_resource>)
@@ -91,11 +124,38 @@
 #        endif
 #    endif
 
+#    if ANKERL_UNORDERED_DENSE_CPP_VERSION >= 202002L && defined(__has_include)
+#        if __has_include(<span>)
+#            include <span> // for span
+#        endif
+#    endif
+
 #    if defined(_MSC_VER) && defined(_M_X64)
 #        include <intrin.h>
 #        pragma intrinsic(_umul128)
 #    endif
 
+// Opt-in x86-64 code that is compiled with target attributes and used when the CPU supports it. It needs <immintrin.h>,
+// which is expensive to compile, so it is only there with ANKERL_UNORDERED_DENSE_X86_DISPATCH. Otherwise hash_aes and
+// hash_many always use the portable code. The macro changes the inline namespace, see ANKERL_UNORDERED_DENSE_NAMESPACE.
+#    if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && defined(ANKERL_UNORDERED_DENSE_X86_DISPATCH)
+#        define ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH 1 // NOLINT(cppcoreguidelines-macro-usage)
+#        include <immintrin.h>                           // for _mm_aesenc_si128, _mm256_mul_epu32
+#    else
+#        define ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH 0 // NOLINT(cppcoreguidelines-macro-usage)
+#    endif
+
+// USDT probes for usdt_observer, e.g. from systemtap-sdt-dev
+#    if defined(__linux__) && defined(__has_include)
+#        if __has_include(<sys/sdt.h>)
+#            define ANKERL_UNORDERED_DENSE_HAS_USDT 1 // NOLINT(cppcoreguidelines-macro-usage)
+#            include <sys/sdt.h>                     // for DTRACE_PROBE4
+#        endif
+#    endif
+#    ifndef ANKERL_UNORDERED_DENSE_HAS_USDT
+#        define ANKERL_UNORDERED_DENSE_HAS_USDT 0 // NOLINT(cppcoreguidelines-macro-usage)
+#    endif
+
 #    if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
 #        define ANKERL_UNORDERED_DENSE_LIKELY(x) __builtin_expect(x, 1)   // NOLINT(cppcoreguidelines-macro-usage)
 #        define ANKERL_UNORDERED_DENSE_UNLIKELY(x) __builtin_expect(x, 0) // NOLINT(cppcoreguidelines-macro-usage)
@@ -104,6 +164,14 @@
 #        define ANKERL_UNORDERED_DENSE_UNLIKELY(x) (x) // NOLINT(cppcoreguidelines-macro-usage)
 #    endif
 
+// adds n to a counter of the table's m_counters, or does nothing when the counters are disabled
+#    if ANKERL_UNORDERED_DENSE_STATS
+#        define ANKERL_UNORDERED_DENSE_COUNT(counter, n) \
+            detail::atomic_table_counters::add(m_counters.counter, (n)) // NOLINT(cppcoreguidelines-macro-usage)
+#    else
+#        define ANKERL_UNORDERED_DENSE_COUNT(counter, n) static_cast<void>(0) // NOLINT(cppcoreguidelines-macro-usage)
+#    endif
+
 namespace ankerl::unordered_dense {
 inline namespace ANKERL_UNORDERED_DENSE_NAMESPACE {
 
@@ -167,12 +235,12 @@ static inline void mum(uint64_t* a, uint64_t* b) {
     return (static_cast<uint64_t>(p[0]) << 16U) | (static_cast<uint64_t>(p[k >> 1U]) << 8U) | p[k - 1];
 }
 
-[[maybe_unused]] [[nodiscard]] static inline auto hash(void const* key, size_t len) -> uint64_t {
-    static constexpr auto secret = std::array{UINT64_C(0xa0761d6478bd642f),
-                                              UINT64_C(0xe7037ed1a0b428db),
-                                              UINT64_C(0x8ebc6af09c88c6e3),
-                                              UINT64_C(0x589965cc75374cc3)};
+static constexpr auto secret = std::array{UINT64_C(0xa0761d6478bd642f),
+                                          UINT64_C(0xe7037ed1a0b428db),
+                                          UINT64_C(0x8ebc6af09c88c6e3),
+                                          UINT64_C(0x589965cc75374cc3)};
 
+[[maybe_unused]] [[nodiscard]] static inline auto hash(void const* key, size_t len) -> uint64_t {
     auto const* p = static_cast<uint8_t const*>(key);
     uint64_t seed = secret[0];
     uint64_t a{};
@@ -220,6 +288,102 @@ static inline void mum(uint64_t* a, uint64_t* b) {
 
 } // namespace detail::wyhash
 
+// Incremental version of wyhash::hash. Feeding the bytes in any number of update() calls gives exactly the same result as
+// one wyhash::hash call over all bytes concatenated, without having to build a temporary buffer. Note that this sees only
+// a stream of bytes: e.g. for two strings "ab" + "c" is the same as "a" + "bc", so add the sizes when that matters.
+class hasher_state {
+    static constexpr size_t stripe_size = 48;
+    static constexpr size_t history_size = 16;
+
+    // [0, 16) holds the last 16 bytes that were already processed, [16, 64) the bytes not yet processed.
+    std::array<uint8_t, history_size + stripe_size> m_buf{};
+    size_t m_buf_len = 0;
+    size_t m_len = 0;
+    uint64_t m_seed = detail::wyhash::secret[0];
+    uint64_t m_see1 = detail::wyhash::secret[0];
+    uint64_t m_see2 = detail::wyhash::secret[0];
+
+    void process_stripe(uint8_t const* p) {
+        using detail::wyhash::mix;
+        using detail::wyhash::r8;
+        using detail::wyhash::secret;
+        m_seed = mix(r8(p) ^ secret[1], r8(p + 8) ^ m_seed);
+        m_see1 = mix(r8(p + 16) ^ secret[2], r8(p + 24) ^ m_see1);
+        m_see2 = mix(r8(p + 32) ^ secret[3], r8(p + 40) ^ m_see2);
+    }
+
+public:
+    auto update(void const* data, size_t len) -> hasher_state& {
+        auto const* p = static_cast<uint8_t const*>(data);
+        m_len += len;
+        while (len > 0) {
+            if (m_buf_len == stripe_size) {
+                // a stripe is only processed when more bytes follow, just like wyhash::hash does
+                process_stripe(m_buf.data() + history_size);
+                std::memcpy(m_buf.data(), m_buf.data() + stripe_size, history_size);
+                m_buf_len = 0;
+            }
+            if (m_buf_len == 0 && len > stripe_size) {
+                // process directly from the input, without copying
+                do {
+                    process_stripe(p);
+                    p += stripe_size;
+                    len -= stripe_size;
+                } while (len > stripe_size);
+                std::memcpy(m_buf.data(), p - history_size, history_size);
+            }
+            auto n = std::min(stripe_size - m_buf_len, len);
+            std::memcpy(m_buf.data() + history_size + m_buf_len, p, n);
+            m_buf_len += n;
+            p += n;
+            len -= n;
+        }
+        return *this;
+    }
+
+    auto update(std::string_view str) -> hasher_state& {
+        return update(str.data(), str.size());
+    }
+
+    // A C string adds its characters, the same as update(std::string_view)
+    auto update(char const* str) -> hasher_state& {
+        return update(std::string_view(str));
+    }
+
+    // Adds the object's memory, so it must not contain any padding. Pointers are not accepted, because hashing the address
+    // instead of what it points to is most likely a mistake; use update(&ptr, sizeof(ptr)) when that is really wanted.
+    template <typename T,
+              typename = std::enable_if_t<std::has_unique_object_representations_v<T> && !std::is_array_v<T> &&
+                                          !std::is_pointer_v<T>>>
+    auto update(T const& obj) -> hasher_state& {
+        return update(&obj, sizeof(T));
+    }
+
+    // Hash of all bytes so far. Doesn't modify the state, so more bytes can be added afterwards.
+    [[nodiscard]] auto finish() const -> uint64_t {
+        using detail::wyhash::mix;
+        using detail::wyhash::r8;
+        using detail::wyhash::secret;
+        if (m_len <= stripe_size) {
+            // everything is still in the buffer
+            return detail::wyhash::hash(m_buf.data() + history_size, m_len);
+        }
+
+        // same as the end of wyhash::hash, but with the last bytes possibly in the history
+        auto const* p = m_buf.data() + history_size;
+        auto i = m_buf_len;
+        auto seed = m_seed ^ m_see1 ^ m_see2;
+        while (ANKERL_UNORDERED_DENSE_UNLIKELY(i > 16)) {
+            seed = mix(r8(p) ^ secret[1], r8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        auto a = r8(p + i - 16);
+        auto b = r8(p + i - 8);
+        return mix(secret[1] ^ m_len, mix(a ^ secret[1], b ^ seed));
+    }
+};
+
 template <typename T, typename Enable = void>
 struct hash {
     auto operator()(T const& obj) const noexcept(noexcept(std::declval<std::hash<T>>().operator()(std::declval<T const&>())))
@@ -314,1173 +478,3732 @@ ANKERL_UNORDERED_DENSE_HASH_STATICCAST(long long);
 ANKERL_UNORDERED_DENSE_HASH_STATICCAST(unsigned long);
 ANKERL_UNORDERED_DENSE_HASH_STATICCAST(unsigned long long);
 
-#    if defined(__GNUC__) && !defined(__clang__)
-#        pragma GCC diagnostic pop
-#    endif
+// integer hash policies /////////////////////////////////////////////////////
 
-// bucket_type //////////////////////////////////////////////////////////
+// Alternatives to hash<T> for integer keys, use them as the Hash template argument. The map takes the bucket index from
+// the upper bits of the hash, and the fingerprint from the lowest byte.
+//
+// hash_identity_avalanching: no mixing at all. Only for keys that are already uniformly random, e.g. precomputed hashes or
+// UUID halves. Sequential or strided keys degrade to long probe sequences.
+template <typename T>
+struct hash_identity_avalanching {
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
 
-namespace bucket_type {
+    using is_avalanching = void;
+    auto operator()(T const& x) const noexcept -> uint64_t {
+        return static_cast<uint64_t>(x);
+    }
+};
 
-struct standard {
-    static constexpr uint32_t dist_inc = 1U << 8U;             // skip 1 byte fingerprint
-    static constexpr uint32_t fingerprint_mask = dist_inc - 1; // mask for 1 byte of fingerprint
+// hash_fibonacci: one 64 bit multiplication with 2^64 / golden ratio. The upper bits spread sequential and strided keys
+// well, but the lower bits (the fingerprint) only depend on the lower bits of the key.
+template <typename T>
+struct hash_fibonacci {
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
 
-    uint32_t m_dist_and_fingerprint; // upper 3 byte: distance to original bucket. lower byte: fingerprint from hash
-    uint32_t m_value_idx;            // index into the m_values vector.
+    using is_avalanching = void;
+    auto operator()(T const& x) const noexcept -> uint64_t {
+        return static_cast<uint64_t>(x) * UINT64_C(0x9E3779B97F4A7C15);
+    }
 };
 
-ANKERL_UNORDERED_DENSE_PACK(struct big {
-    static constexpr uint32_t dist_inc = 1U << 8U;             // skip 1 byte fingerprint
-    static constexpr uint32_t fingerprint_mask = dist_inc - 1; // mask for 1 byte of fingerprint
+// hash_murmur_fmix: MurmurHash3's 64 bit finalizer. Full avalanching without a 128 bit multiplication, for platforms where
+// that is slow.
+template <typename T>
+struct hash_murmur_fmix {
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
 
-    uint32_t m_dist_and_fingerprint; // upper 3 byte: distance to original bucket. lower byte: fingerprint from hash
-    size_t m_value_idx;              // index into the m_values vector.
-});
+    using is_avalanching = void;
+    auto operator()(T const& x) const noexcept -> uint64_t {
+        auto h = static_cast<uint64_t>(x);
+        h ^= h >> 33U;
+        h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33U;
+        h *= UINT64_C(0xc4ceb9fe1a85ec53);
+        h ^= h >> 33U;
+        return h;
+    }
+};
 
-} // namespace bucket_type
+#    if defined(__GNUC__) && !defined(__clang__)
+#        pragma GCC diagnostic pop
+#    endif
 
 namespace detail {
 
-struct nonesuch {};
+// Hashes the bit pattern of a float or double. -0.0 == 0.0, so both must have the same hash. All NaNs get the same hash,
+// even though they never compare equal.
+template <typename Float, typename UInt>
+[[nodiscard]] auto hash_float(Float f) noexcept -> uint64_t {
+    static_assert(sizeof(Float) == sizeof(UInt));
+    if (f == Float{}) {
+        f = Float{};
+    } else if (std::isnan(f)) {
+        f = std::numeric_limits<Float>::quiet_NaN();
+    }
+    UInt bits{};
+    std::memcpy(&bits, &f, sizeof(f));
+    return wyhash::hash(bits);
+}
 
-template <class Default, class AlwaysVoid, template <class...> class Op, class... Args>
-struct detector {
-    using value_t = std::false_type;
-    using type = Default;
-};
+} // namespace detail
 
-template <class Default, template <class...> class Op, class... Args>
-struct detector<Default, std::void_t<Op<Args...>>, Op, Args...> {
-    using value_t = std::true_type;
-    using type = Op<Args...>;
+template <>
+struct hash<float> {
+    using is_avalanching = void;
+    auto operator()(float f) const noexcept -> uint64_t {
+        return detail::hash_float<float, uint32_t>(f);
+    }
 };
 
-template <template <class...> class Op, class... Args>
-using is_detected = typename detail::detector<detail::nonesuch, void, Op, Args...>::value_t;
-
-template <template <class...> class Op, class... Args>
-constexpr bool is_detected_v = is_detected<Op, Args...>::value;
-
-template <typename T>
-using detect_avalanching = typename T::is_avalanching;
+template <>
+struct hash<double> {
+    using is_avalanching = void;
+    auto operator()(double d) const noexcept -> uint64_t {
+        return detail::hash_float<double, uint64_t>(d);
+    }
+};
 
-template <typename T>
-using detect_is_transparent = typename T::is_transparent;
+// True when two objects are equal exactly when their memory is equal, so their bytes can be hashed directly. This is the
+// case for integers, enums, and pointers. Specialize it for your own types where operator== compares all members and that
+// have unique object representations (no padding). Then the type, std::array and std::vector of it are hashed with a
+// single wyhash::hash call.
+template <typename T, typename Enable = void>
+struct is_bytewise_hashable
+    : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
 
 template <typename T>
-using detect_iterator = typename T::iterator;
+inline constexpr bool is_bytewise_hashable_v = is_bytewise_hashable<T>::value;
 
 template <typename T>
-using detect_reserve = decltype(std::declval<T&>().reserve(size_t{}));
-
-// enable_if helpers
-
-template <typename Mapped>
-constexpr bool is_map_v = !std::is_void_v<Mapped>;
-
-// clang-format off
-template <typename Hash, typename KeyEqual>
-constexpr bool is_transparent_v = is_detected_v<detect_is_transparent, Hash>&& is_detected_v<detect_is_transparent, KeyEqual>;
-// clang-format on
+struct hash<T, std::enable_if_t<std::is_class_v<T> && is_bytewise_hashable_v<T>>> {
+    static_assert(std::has_unique_object_representations_v<T>, "padding bytes can't be hashed");
 
-template <typename From, typename To1, typename To2>
-constexpr bool is_neither_convertible_v = !std::is_convertible_v<From, To1> && !std::is_convertible_v<From, To2>;
+    using is_avalanching = void;
+    auto operator()(T const& obj) const noexcept -> uint64_t {
+        return detail::wyhash::hash(&obj, sizeof(T));
+    }
+};
 
-template <typename T>
-constexpr bool has_reserve = is_detected_v<detect_reserve, T>;
+template <typename T, typename Allocator>
+struct hash<std::vector<T, Allocator>, std::enable_if_t<is_bytewise_hashable_v<T> && !std::is_same_v<T, bool>>> {
+    static_assert(std::has_unique_object_representations_v<T>, "padding bytes can't be hashed");
 
-// base type for map has mapped_type
-template <class T>
-struct base_table_type_map {
-    using mapped_type = T;
+    using is_avalanching = void;
+    auto operator()(std::vector<T, Allocator> const& vec) const noexcept -> uint64_t {
+        return detail::wyhash::hash(vec.data(), sizeof(T) * vec.size());
+    }
 };
 
-// base type for set doesn't have mapped_type
-struct base_table_type_set {};
-
-// This is it, the table. Doubles as map and set, and uses `void` for T when its used as a set.
-template <class Key,
-          class T, // when void, treat it as a set.
-          class Hash,
-          class KeyEqual,
-          class AllocatorOrContainer,
-          class Bucket>
-class table : public std::conditional_t<is_map_v<T>, base_table_type_map<T>, base_table_type_set> {
-public:
-    using value_container_type = std::conditional_t<
-        is_detected_v<detect_iterator, AllocatorOrContainer>,
-        AllocatorOrContainer,
-        typename std::vector<typename std::conditional_t<is_map_v<T>, std::pair<Key, T>, Key>, AllocatorOrContainer>>;
+#    if ANKERL_UNORDERED_DENSE_CPP_VERSION >= 202002L && defined(__cpp_lib_span)
 
-private:
-    using bucket_alloc =
-        typename std::allocator_traits<typename value_container_type::allocator_type>::template rebind_alloc<Bucket>;
-    using bucket_alloc_traits = std::allocator_traits<bucket_alloc>;
+template <typename T, size_t Extent>
+struct hash<std::span<T, Extent>, std::enable_if_t<is_bytewise_hashable_v<std::remove_cv_t<T>>>> {
+    static_assert(std::has_unique_object_representations_v<std::remove_cv_t<T>>, "padding bytes can't be hashed");
 
-    static constexpr uint8_t initial_shifts = 64 - 3; // 2^(64-m_shift) number of buckets
-    static constexpr float default_max_load_factor = 0.8F;
+    using is_avalanching = void;
+    auto operator()(std::span<T, Extent> const& sp) const noexcept -> uint64_t {
+        return detail::wyhash::hash(sp.data(), sp.size_bytes());
+    }
+};
 
-public:
-    using key_type = Key;
-    using value_type = typename value_container_type::value_type;
-    using size_type = typename value_container_type::size_type;
-    using difference_type = typename value_container_type::difference_type;
-    using hasher = Hash;
-    using key_equal = KeyEqual;
-    using allocator_type = typename value_container_type::allocator_type;
-    using reference = typename value_container_type::reference;
-    using const_reference = typename value_container_type::const_reference;
-    using pointer = typename value_container_type::pointer;
-    using const_pointer = typename value_container_type::const_pointer;
-    using const_iterator = typename value_container_type::const_iterator;
-    using iterator = std::conditional_t<is_map_v<T>, typename value_container_type::iterator, const_iterator>;
-    using bucket_type = Bucket;
+#    endif
 
-private:
-    using value_idx_type = decltype(Bucket::m_value_idx);
-    using dist_and_fingerprint_type = decltype(Bucket::m_dist_and_fingerprint);
+namespace detail {
 
-    static_assert(std::is_trivially_destructible_v<Bucket>, "assert there's no need to call destructor / std::destroy");
-    static_assert(std::is_trivially_copyable_v<Bucket>, "assert we can just memset / memcpy");
+// Combines the hash h of an element into the seed. h doesn't need to be of high quality, the result is avalanching.
+[[nodiscard]] inline auto hash_combine(uint64_t seed, uint64_t h) -> uint64_t {
+    return wyhash::mix(seed ^ h, UINT64_C(0x9E3779B97F4A7C15));
+}
 
-    value_container_type m_values{}; // Contains all the key-value pairs in one densely stored container. No holes.
-    typename std::allocator_traits<bucket_alloc>::pointer m_buckets{};
-    size_t m_num_buckets = 0;
-    size_t m_max_bucket_capacity = 0;
-    float m_max_load_factor = default_max_load_factor;
-    Hash m_hash{};
-    KeyEqual m_equal{};
-    uint8_t m_shifts = initial_shifts;
+static constexpr uint64_t hash_combine_seed = UINT64_C(0xe7037ed1a0b428db);
 
-    [[nodiscard]] auto next(value_idx_type bucket_idx) const -> value_idx_type {
-        return ANKERL_UNORDERED_DENSE_UNLIKELY(bucket_idx + 1U == m_num_buckets)
-                   ? 0
-                   : static_cast<value_idx_type>(bucket_idx + 1U);
-    }
+template <typename... Ts>
+[[nodiscard]] auto hash_elements(Ts const&... elements) -> uint64_t {
+    auto h = hash_combine_seed;
+    ((h = hash_combine(h, hash<Ts>{}(elements))), ...);
+    return h;
+}
 
-    // Helper to access bucket through pointer types
-    [[nodiscard]] static constexpr auto at(typename std::allocator_traits<bucket_alloc>::pointer bucket_ptr, size_t offset)
-        -> Bucket& {
-        return *(bucket_ptr + static_cast<typename std::allocator_traits<bucket_alloc>::difference_type>(offset));
-    }
+} // namespace detail
 
-    // use the dist_inc and dist_dec functions so that uint16_t types work without warning
-    [[nodiscard]] static constexpr auto dist_inc(dist_and_fingerprint_type x) -> dist_and_fingerprint_type {
-        return static_cast<dist_and_fingerprint_type>(x + Bucket::dist_inc);
+template <typename A, typename B>
+struct hash<std::pair<A, B>> {
+    using is_avalanching = void;
+    auto operator()(std::pair<A, B> const& p) const -> uint64_t {
+        return detail::hash_elements(p.first, p.second);
     }
+};
 
-    [[nodiscard]] static constexpr auto dist_dec(dist_and_fingerprint_type x) -> dist_and_fingerprint_type {
-        return static_cast<dist_and_fingerprint_type>(x - Bucket::dist_inc);
+template <typename... Ts>
+struct hash<std::tuple<Ts...>> {
+    using is_avalanching = void;
+    auto operator()(std::tuple<Ts...> const& t) const -> uint64_t {
+        return std::apply(detail::hash_elements<Ts...>, t);
     }
+};
 
-    // The goal of mixed_hash is to always produce a high quality 64bit hash.
-    template <typename K>
-    [[nodiscard]] constexpr auto mixed_hash(K const& key) const -> uint64_t {
-        if constexpr (is_detected_v<detect_avalanching, Hash>) {
-            // we know that the hash is good because is_avalanching.
-            if constexpr (sizeof(decltype(m_hash(key))) < sizeof(uint64_t)) {
-                // 32bit hash and is_avalanching => multiply with a constant to avalanche bits upwards
-                return m_hash(key) * UINT64_C(0x9ddfea08eb382d69);
-            } else {
-                // 64bit and is_avalanching => only use the hash itself.
-                return m_hash(key);
-            }
+template <typename T, size_t N>
+struct hash<std::array<T, N>> {
+    using is_avalanching = void;
+    auto operator()(std::array<T, N> const& a) const -> uint64_t {
+        if constexpr (is_bytewise_hashable_v<T>) {
+            static_assert(std::has_unique_object_representations_v<T>, "padding bytes can't be hashed");
+            // not sizeof(a): an empty std::array still has a size, but data() can be nullptr
+            return detail::wyhash::hash(a.data(), sizeof(T) * N);
         } else {
-            // not is_avalanching => apply wyhash
-            return wyhash::hash(m_hash(key));
+            auto h = detail::hash_combine_seed;
+            for (auto const& x : a) {
+                h = detail::hash_combine(h, hash<T>{}(x));
+            }
+            return h;
         }
     }
+};
 
-    [[nodiscard]] constexpr auto dist_and_fingerprint_from_hash(uint64_t hash) const -> dist_and_fingerprint_type {
-        return Bucket::dist_inc | (static_cast<dist_and_fingerprint_type>(hash) & Bucket::fingerprint_mask);
+template <typename T>
+struct hash<std::optional<T>> {
+    using is_avalanching = void;
+    auto operator()(std::optional<T> const& o) const -> uint64_t {
+        // an empty optional hashes differently than any of the values
+        return o ? detail::hash_elements(*o) : detail::hash_combine_seed;
     }
+};
 
-    [[nodiscard]] constexpr auto bucket_idx_from_hash(uint64_t hash) const -> value_idx_type {
-        return static_cast<value_idx_type>(hash >> m_shifts);
-    }
+// aes hash ///////////////////////////////////////////////////////////////////
 
-    [[nodiscard]] static constexpr auto get_key(value_type const& vt) -> key_type const& {
-        if constexpr (is_map_v<T>) {
-            return vt.first;
-        } else {
-            return vt;
+namespace detail::aes {
+
+#    if ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH
+
+[[nodiscard]] inline auto is_supported() -> bool {
+    static bool const supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("aes") != 0;
+    }();
+    return supported;
+}
+
+[[nodiscard]] __attribute__((target("aes"))) inline auto load(uint8_t const* p) -> __m128i {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+// Absorbs 16 bytes of data into the lane with one AES round.
+[[nodiscard]] __attribute__((target("aes"))) inline auto absorb(__m128i lane, uint8_t const* p, __m128i key) -> __m128i {
+    return _mm_aesenc_si128(_mm_xor_si128(lane, load(p)), key);
+}
+
+// Hashes with AES rounds, 16 bytes per round and up to 4 independent lanes. Each byte of input goes through at least 3
+// rounds, which is enough for full diffusion. Only available when is_supported(), and only for len > 16: for shorter keys
+// wyhash is faster.
+[[nodiscard]] __attribute__((target("aes"))) inline auto hash(void const* key, size_t len) -> uint64_t {
+    // wyhash's secret and the fractional digits of pi
+    auto const k0 = _mm_set_epi64x(static_cast<int64_t>(UINT64_C(0xa0761d6478bd642f)),
+                                   static_cast<int64_t>(UINT64_C(0xe7037ed1a0b428db)));
+    auto const k1 = _mm_set_epi64x(static_cast<int64_t>(UINT64_C(0x8ebc6af09c88c6e3)),
+                                   static_cast<int64_t>(UINT64_C(0x589965cc75374cc3)));
+    auto const k2 = _mm_set_epi64x(static_cast<int64_t>(UINT64_C(0x243f6a8885a308d3)),
+                                   static_cast<int64_t>(UINT64_C(0x13198a2e03707344)));
+    auto const k3 = _mm_set_epi64x(static_cast<int64_t>(UINT64_C(0xa4093822299f31d0)),
+                                   static_cast<int64_t>(UINT64_C(0x082efa98ec4e6c89)));
+
+    auto const* p = static_cast<uint8_t const*>(key);
+    auto a = _mm_xor_si128(k0, _mm_cvtsi64_si128(static_cast<int64_t>(len)));
+    auto b = k1;
+    if (len <= 32) {
+        a = absorb(a, p, k1);
+        b = absorb(b, p + len - 16, k0);
+    } else {
+        auto const* end = p + len;
+        auto c = k2;
+        auto d = k3;
+        while (end - p > 64) {
+            a = absorb(a, p, k1);
+            b = absorb(b, p + 16, k0);
+            c = absorb(c, p + 32, k3);
+            d = absorb(d, p + 48, k2);
+            p += 64;
         }
+        // the last 1 to 64 bytes. Read the last 64 bytes (overlapping) when possible, or the whole data.
+        auto const* first = len > 64 ? end - 64 : p;
+        a = absorb(a, first, k1);
+        b = absorb(b, first + 16, k0);
+        c = absorb(c, end - 32, k3);
+        d = absorb(d, end - 16, k2);
+        a = _mm_aesenc_si128(a, c);
+        b = _mm_aesenc_si128(b, d);
     }
 
-    template <typename K>
-    [[nodiscard]] auto next_while_less(K const& key) const -> Bucket {
-        auto hash = mixed_hash(key);
-        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
-        auto bucket_idx = bucket_idx_from_hash(hash);
+    auto h = _mm_aesenc_si128(a, b);
+    h = _mm_aesenc_si128(h, k0);
+    h = _mm_aesenc_si128(h, k1);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(h)) ^ static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(h, h)));
+}
 
-        while (dist_and_fingerprint < at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
-        }
-        return {dist_and_fingerprint, bucket_idx};
-    }
+#    endif
 
-    void place_and_shift_up(Bucket bucket, value_idx_type place) {
-        while (0 != at(m_buckets, place).m_dist_and_fingerprint) {
-            bucket = std::exchange(at(m_buckets, place), bucket);
-            bucket.m_dist_and_fingerprint = dist_inc(bucket.m_dist_and_fingerprint);
-            place = next(place);
-        }
-        at(m_buckets, place) = bucket;
+// AES based hash when the CPU supports it, otherwise wyhash. The result is not stable across machines.
+[[nodiscard]] inline auto hash_bytes(void const* key, size_t len) -> uint64_t {
+#    if ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH
+    if (len > 16 && is_supported()) {
+        return hash(key, len);
     }
+#    endif
+    return wyhash::hash(key, len);
+}
 
-    [[nodiscard]] static constexpr auto calc_num_buckets(uint8_t shifts) -> size_t {
-        return std::min(max_bucket_count(), size_t{1} << (64U - shifts));
-    }
+} // namespace detail::aes
 
-    [[nodiscard]] constexpr auto calc_shifts_for_size(size_t s) const -> uint8_t {
-        auto shifts = initial_shifts;
-        while (shifts > 0 && static_cast<size_t>(static_cast<float>(calc_num_buckets(shifts)) * max_load_factor()) < s) {
-            --shifts;
-        }
-        return shifts;
-    }
+// Same as hash<T>, but with ANKERL_UNORDERED_DENSE_X86_DISPATCH strings longer than 16 bytes are hashed with AES-NI
+// instructions when the CPU supports them (checked once at runtime). Otherwise this is wyhash.
+template <typename T, typename Enable = void>
+struct hash_aes : hash<T> {};
 
-    // assumes m_values has data, m_buckets=m_buckets_end=nullptr, m_shifts is INITIAL_SHIFTS
-    void copy_buckets(table const& other) {
-        if (!empty()) {
-            m_shifts = other.m_shifts;
-            allocate_buckets_from_shift();
-            std::memcpy(m_buckets, other.m_buckets, sizeof(Bucket) * bucket_count());
-        }
+template <typename CharT>
+struct hash_aes<std::basic_string<CharT>> {
+    using is_avalanching = void;
+    auto operator()(std::basic_string<CharT> const& str) const noexcept -> uint64_t {
+        return detail::aes::hash_bytes(str.data(), sizeof(CharT) * str.size());
     }
+};
 
-    /**
-     * True when no element can be added any more without increasing the size
-     */
-    [[nodiscard]] auto is_full() const -> bool {
-        return size() >= m_max_bucket_capacity;
+template <typename CharT>
+struct hash_aes<std::basic_string_view<CharT>> {
+    using is_avalanching = void;
+    auto operator()(std::basic_string_view<CharT> const& sv) const noexcept -> uint64_t {
+        return detail::aes::hash_bytes(sv.data(), sizeof(CharT) * sv.size());
     }
+};
 
-    void deallocate_buckets() {
-        auto ba = bucket_alloc(m_values.get_allocator());
-        if (nullptr != m_buckets) {
-            bucket_alloc_traits::deallocate(ba, m_buckets, bucket_count());
-        }
-        m_buckets = nullptr;
-        m_num_buckets = 0;
-        m_max_bucket_capacity = 0;
-    }
+// batch hashing //////////////////////////////////////////////////////////////
 
-    void allocate_buckets_from_shift() {
-        auto ba = bucket_alloc(m_values.get_allocator());
-        m_num_buckets = calc_num_buckets(m_shifts);
-        m_buckets = bucket_alloc_traits::allocate(ba, m_num_buckets);
-        if (m_num_buckets == max_bucket_count()) {
-            // reached the maximum, make sure we can use each bucket
-            m_max_bucket_capacity = max_bucket_count();
-        } else {
-            m_max_bucket_capacity = static_cast<value_idx_type>(static_cast<float>(m_num_buckets) * max_load_factor());
-        }
-    }
+namespace detail {
 
-    void clear_buckets() {
-        if (m_buckets != nullptr) {
-            std::memset(&*m_buckets, 0, sizeof(Bucket) * bucket_count());
-        }
-    }
+#    if ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH
 
-    void clear_and_fill_buckets_from_values() {
-        clear_buckets();
-        for (value_idx_type value_idx = 0, end_idx = static_cast<value_idx_type>(m_values.size()); value_idx < end_idx;
-             ++value_idx) {
-            auto const& key = get_key(m_values[value_idx]);
-            auto [dist_and_fingerprint, bucket] = next_while_less(key);
+[[nodiscard]] inline auto has_avx2() -> bool {
+    static bool const supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
 
-            // we know for certain that key has not yet been inserted, so no need to check it.
-            place_and_shift_up({dist_and_fingerprint, value_idx}, bucket);
-        }
+// Same as wyhash::hash(uint64_t) for 4 keys at once. AVX2 has no 64x64 => 128 bit multiplication, so it is built from
+// four 32x32 => 64 bit multiplications.
+__attribute__((target("avx2"))) inline void wyhash_many_avx2(void const* keys, size_t count, uint64_t* hashes) {
+    auto const* in = static_cast<uint8_t const*>(keys);
+    auto const k_lo = _mm256_set1_epi64x(INT64_C(0x7F4A7C15));
+    auto const k_hi = _mm256_set1_epi64x(INT64_C(0x9E3779B9));
+    auto const mask32 = _mm256_set1_epi64x(INT64_C(0xFFFFFFFF));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i * sizeof(uint64_t)));
+        auto x_hi = _mm256_srli_epi64(x, 32);
+        auto ll = _mm256_mul_epu32(x, k_lo);
+        auto lh = _mm256_mul_epu32(x, k_hi);
+        auto hl = _mm256_mul_epu32(x_hi, k_lo);
+        auto hh = _mm256_mul_epu32(x_hi, k_hi);
+
+        // sum of the middle 32 bit parts, at most 34 bits
+        auto mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                                    _mm256_add_epi64(_mm256_and_si256(lh, mask32), _mm256_and_si256(hl, mask32)));
+        auto lo = _mm256_or_si256(_mm256_slli_epi64(mid, 32), _mm256_and_si256(ll, mask32));
+        auto hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)),
+                                   _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hashes + i), _mm256_xor_si256(lo, hi));
     }
+    for (; i < count; ++i) {
+        uint64_t x{};
+        std::memcpy(&x, in + i * sizeof(uint64_t), sizeof(uint64_t));
+        hashes[i] = wyhash::hash(x);
+    }
+}
 
-    void increase_size() {
-        if (ANKERL_UNORDERED_DENSE_UNLIKELY(m_max_bucket_capacity == max_bucket_count())) {
-            throw std::overflow_error("ankerl::unordered_dense: reached max bucket size, cannot increase size");
+#    endif
+
+} // namespace detail
+
+// Hashes count keys into hashes, exactly the same as calling h(key) for each key. For 8 byte integer keys with the default
+// hash, 4 keys are hashed at once with AVX2 when ANKERL_UNORDERED_DENSE_X86_DISPATCH is defined and the CPU supports it.
+template <typename Key, typename Hash = hash<Key>>
+void hash_many(Key const* keys, size_t count, uint64_t* hashes, Hash const& h = Hash()) {
+#    if ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH
+    if constexpr (std::is_integral_v<Key> && sizeof(Key) == sizeof(uint64_t) && std::is_same_v<Hash, hash<Key>>) {
+        if (detail::has_avx2()) {
+            return detail::wyhash_many_avx2(keys, count, hashes);
         }
-        --m_shifts;
-        deallocate_buckets();
-        allocate_buckets_from_shift();
-        clear_and_fill_buckets_from_values();
     }
+#    endif
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = h(keys[i]);
+    }
+}
 
-    void do_erase(value_idx_type bucket_idx) {
-        auto const value_idx_to_remove = at(m_buckets, bucket_idx).m_value_idx;
+#    if ANKERL_UNORDERED_DENSE_CPP_VERSION >= 202002L && defined(__cpp_lib_span)
 
-        // shift down until either empty or an element with correct spot is found
-        auto next_bucket_idx = next(bucket_idx);
-        while (at(m_buckets, next_bucket_idx).m_dist_and_fingerprint >= Bucket::dist_inc * 2) {
-            at(m_buckets, bucket_idx) = {dist_dec(at(m_buckets, next_bucket_idx).m_dist_and_fingerprint),
-                                         at(m_buckets, next_bucket_idx).m_value_idx};
-            bucket_idx = std::exchange(next_bucket_idx, next(next_bucket_idx));
-        }
-        at(m_buckets, bucket_idx) = {};
+// hashes.size() must be at least keys.size()
+template <typename Key, typename Hash = hash<Key>>
+void hash_many(std::span<Key const> keys, std::span<uint64_t> hashes, Hash const& h = Hash()) {
+    hash_many(keys.data(), keys.size(), hashes.data(), h);
+}
 
-        // update m_values
-        if (value_idx_to_remove != m_values.size() - 1) {
-            // no luck, we'll have to replace the value with the last one and update the index accordingly
-            auto& val = m_values[value_idx_to_remove];
-            val = std::move(m_values.back());
+#    endif
 
-            // update the values_idx of the moved entry. No need to play the info game, just look until we find the values_idx
-            auto mh = mixed_hash(get_key(val));
-            bucket_idx = bucket_idx_from_hash(mh);
+// prehashed //////////////////////////////////////////////////////////////////
 
-            auto const values_idx_back = static_cast<value_idx_type>(m_values.size() - 1);
-            while (values_idx_back != at(m_buckets, bucket_idx).m_value_idx) {
-                bucket_idx = next(bucket_idx);
-            }
-            at(m_buckets, bucket_idx).m_value_idx = value_idx_to_remove;
-        }
-        m_values.pop_back();
-    }
+// A key together with its hash. When the same key is looked up in several maps, it only needs to be hashed once. Use it
+// with prehashed_hash and prehashed_equal, either only for lookups, or also as the map's key so that comparisons can reject
+// different keys by their hash, and rehashing doesn't need to hash any key.
+template <typename Key, typename Hash = hash<Key>>
+class prehashed {
+    Key m_key;
+    uint64_t m_hash;
 
-    template <typename K>
-    auto do_erase_key(K&& key) -> size_t {
-        if (empty()) {
-            return 0;
-        }
+public:
+    using hasher = Hash;
 
-        auto [dist_and_fingerprint, bucket_idx] = next_while_less(key);
+    explicit prehashed(Key key, Hash const& h = Hash())
+        : m_key(std::move(key))
+        , m_hash(h(m_key)) {}
 
-        while (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
-               !m_equal(key, get_key(m_values[at(m_buckets, bucket_idx).m_value_idx]))) {
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
-        }
+    [[nodiscard]] auto key() const noexcept -> Key const& {
+        return m_key;
+    }
 
-        if (dist_and_fingerprint != at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
-            return 0;
-        }
-        do_erase(bucket_idx);
-        return 1;
+    [[nodiscard]] auto hash() const noexcept -> uint64_t {
+        return m_hash;
     }
 
-    template <class K, class M>
-    auto do_insert_or_assign(K&& key, M&& mapped) -> std::pair<iterator, bool> {
-        auto it_isinserted = try_emplace(std::forward<K>(key), std::forward<M>(mapped));
-        if (!it_isinserted.second) {
-            it_isinserted.first->second = std::forward<M>(mapped);
-        }
-        return it_isinserted;
+    template <typename OtherKey>
+    [[nodiscard]] auto operator==(prehashed<OtherKey, Hash> const& other) const -> bool {
+        return m_hash == other.hash() && m_key == other.key();
     }
 
-    template <typename K, typename... Args>
-    auto do_place_element(dist_and_fingerprint_type dist_and_fingerprint, value_idx_type bucket_idx, K&& key, Args&&... args)
-        -> std::pair<iterator, bool> {
+    template <typename OtherKey>
+    [[nodiscard]] auto operator!=(prehashed<OtherKey, Hash> const& other) const -> bool {
+        return !(*this == other);
+    }
+};
 
-        // emplace the new value. If that throws an exception, no harm done; index is still in a valid state
-        m_values.emplace_back(std::piecewise_construct,
-                              std::forward_as_tuple(std::forward<K>(key)),
-                              std::forward_as_tuple(std::forward<Args>(args)...));
+// hashed_string_view is for lookups, hashed_string can be used as the key of a map. Both use the same hash as
+// std::string and std::string_view.
+using hashed_string_view = prehashed<std::string_view, hash<std::string_view>>;
+using hashed_string = prehashed<std::string, hash<std::string_view>>;
 
-        // place element and shift up until we find an empty spot
-        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
-        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
-        return {begin() + static_cast<difference_type>(value_idx), true};
-    }
+namespace detail {
 
-    template <typename K, typename... Args>
-    auto do_try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
-        if (ANKERL_UNORDERED_DENSE_UNLIKELY(is_full())) {
-            increase_size();
-        }
+template <typename T>
+struct is_prehashed : std::false_type {};
 
-        auto hash = mixed_hash(key);
-        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
-        auto bucket_idx = bucket_idx_from_hash(hash);
+template <typename Key, typename Hash>
+struct is_prehashed<prehashed<Key, Hash>> : std::true_type {};
 
-        while (true) {
-            auto* bucket = &at(m_buckets, bucket_idx);
-            if (dist_and_fingerprint == bucket->m_dist_and_fingerprint) {
-                if (m_equal(key, m_values[bucket->m_value_idx].first)) {
-                    return {begin() + static_cast<difference_type>(bucket->m_value_idx), false};
-                }
-            } else if (dist_and_fingerprint > bucket->m_dist_and_fingerprint) {
-                return do_place_element(dist_and_fingerprint, bucket_idx, std::forward<K>(key), std::forward<Args>(args)...);
-            }
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
-        }
+template <typename T>
+[[nodiscard]] auto unwrap_prehashed(T const& key) -> auto const& {
+    if constexpr (is_prehashed<T>::value) {
+        return key.key();
+    } else {
+        return key;
     }
+}
 
-    template <typename K>
-    auto do_find(K const& key) -> iterator {
-        if (ANKERL_UNORDERED_DENSE_UNLIKELY(empty())) {
-            return end();
-        }
+template <typename Hash, typename Enable = void>
+struct avalanching_if {};
 
-        auto mh = mixed_hash(key);
-        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(mh);
-        auto bucket_idx = bucket_idx_from_hash(mh);
-        auto* bucket = &at(m_buckets, bucket_idx);
+template <typename Hash>
+struct avalanching_if<Hash, std::void_t<typename Hash::is_avalanching>> {
+    using is_avalanching = void;
+};
 
-        // unrolled loop. *Always* check a few directly, then enter the loop. This is faster.
-        if (dist_and_fingerprint == bucket->m_dist_and_fingerprint && m_equal(key, get_key(m_values[bucket->m_value_idx]))) {
-            return begin() + static_cast<difference_type>(bucket->m_value_idx);
-        }
-        dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-        bucket_idx = next(bucket_idx);
-        bucket = &at(m_buckets, bucket_idx);
+} // namespace detail
 
-        if (dist_and_fingerprint == bucket->m_dist_and_fingerprint && m_equal(key, get_key(m_values[bucket->m_value_idx]))) {
-            return begin() + static_cast<difference_type>(bucket->m_value_idx);
-        }
-        dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-        bucket_idx = next(bucket_idx);
-        bucket = &at(m_buckets, bucket_idx);
+// Transparent hash: returns the stored hash of prehashed<Key, Hash>, and hashes all other keys with Hash. It is avalanching
+// when Hash is.
+template <typename Hash = hash<std::string_view>>
+struct prehashed_hash : detail::avalanching_if<Hash> {
+    using is_transparent = void;
 
-        while (true) {
-            if (dist_and_fingerprint == bucket->m_dist_and_fingerprint) {
-                if (m_equal(key, get_key(m_values[bucket->m_value_idx]))) {
-                    return begin() + static_cast<difference_type>(bucket->m_value_idx);
-                }
-            } else if (dist_and_fingerprint > bucket->m_dist_and_fingerprint) {
-                return end();
-            }
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
-            bucket = &at(m_buckets, bucket_idx);
-        }
+    template <typename Key>
+    auto operator()(prehashed<Key, Hash> const& key) const noexcept -> uint64_t {
+        return key.hash();
     }
 
-    template <typename K>
-    auto do_find(K const& key) const -> const_iterator {
-        return const_cast<table*>(this)->do_find(key); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    template <typename Key, typename = std::enable_if_t<!detail::is_prehashed<Key>::value>>
+    auto operator()(Key const& key) const -> uint64_t {
+        return Hash{}(key);
     }
+};
 
-    template <typename K, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto do_at(K const& key) -> Q& {
-        if (auto it = find(key); end() != it) {
-            return it->second;
+// Transparent equality for prehashed and plain keys. When both sides are prehashed the hashes are compared first.
+struct prehashed_equal {
+    using is_transparent = void;
+
+    template <typename A, typename B>
+    auto operator()(A const& a, B const& b) const -> bool {
+        if constexpr (detail::is_prehashed<A>::value && detail::is_prehashed<B>::value) {
+            return a == b;
+        } else {
+            return detail::unwrap_prehashed(a) == detail::unwrap_prehashed(b);
         }
-        throw std::out_of_range("ankerl::unordered_dense::map::at(): key not found");
     }
+};
 
-    template <typename K, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto do_at(K const& key) const -> Q const& {
-        return const_cast<table*>(this)->at(key); // NOLINT(cppcoreguidelines-pro-type-const-cast)
-    }
+// small_key //////////////////////////////////////////////////////////////////
+
+// A string of at most N characters that is stored inline. It is trivially copyable, so the map's values can be moved with
+// memcpy, and comparison is a memcmp of N bytes with a compile time constant size. Unused characters are always zero, so two
+// keys are equal exactly when their bytes are.
+template <size_t N>
+class small_key {
+    static_assert(N > 0 && N <= std::numeric_limits<uint8_t>::max(), "small_key stores its size in one byte");
+
+    std::array<char, N> m_data{};
+    uint8_t m_size = 0;
 
 public:
-    table()
-        : table(0) {}
+    constexpr small_key() noexcept = default;
 
-    explicit table(size_t bucket_count,
-                   Hash const& hash = Hash(),
-                   KeyEqual const& equal = KeyEqual(),
-                   allocator_type const& alloc_or_container = allocator_type())
-        : m_values(alloc_or_container)
-        , m_hash(hash)
-        , m_equal(equal) {
-        if (0 != bucket_count) {
-            reserve(bucket_count);
+    constexpr explicit small_key(std::string_view str)
+        : m_size(static_cast<uint8_t>(str.size())) {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(str.size() > N)) {
+            throw std::length_error("ankerl::unordered_dense::small_key: string is too long");
+        }
+        for (size_t i = 0; i < str.size(); ++i) {
+            m_data[i] = str[i];
         }
     }
 
-    table(size_t bucket_count, allocator_type const& alloc)
-        : table(bucket_count, Hash(), KeyEqual(), alloc) {}
+    constexpr explicit small_key(char const* str)
+        : small_key(std::string_view(str)) {}
 
-    table(size_t bucket_count, Hash const& hash, allocator_type const& alloc)
-        : table(bucket_count, hash, KeyEqual(), alloc) {}
+    [[nodiscard]] constexpr auto data() const noexcept -> char const* {
+        return m_data.data();
+    }
 
-    explicit table(allocator_type const& alloc)
-        : table(0, Hash(), KeyEqual(), alloc) {}
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+        return m_size;
+    }
 
-    template <class InputIt>
-    table(InputIt first,
-          InputIt last,
-          size_type bucket_count = 0,
-          Hash const& hash = Hash(),
-          KeyEqual const& equal = KeyEqual(),
-          allocator_type const& alloc = allocator_type())
-        : table(bucket_count, hash, equal, alloc) {
-        insert(first, last);
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+        return 0 == m_size;
     }
 
-    template <class InputIt>
-    table(InputIt first, InputIt last, size_type bucket_count, allocator_type const& alloc)
-        : table(first, last, bucket_count, Hash(), KeyEqual(), alloc) {}
+    [[nodiscard]] static constexpr auto capacity() noexcept -> size_t {
+        return N;
+    }
 
-    template <class InputIt>
-    table(InputIt first, InputIt last, size_type bucket_count, Hash const& hash, allocator_type const& alloc)
-        : table(first, last, bucket_count, hash, KeyEqual(), alloc) {}
+    [[nodiscard]] constexpr auto str() const noexcept -> std::string_view {
+        return {m_data.data(), m_size};
+    }
 
-    table(table const& other)
-        : table(other, other.m_values.get_allocator()) {}
+    constexpr operator std::string_view() const noexcept { // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        return str();
+    }
 
-    table(table const& other, allocator_type const& alloc)
-        : m_values(other.m_values, alloc)
-        , m_max_load_factor(other.m_max_load_factor)
-        , m_hash(other.m_hash)
-        , m_equal(other.m_equal) {
-        copy_buckets(other);
+    friend auto operator==(small_key const& a, small_key const& b) noexcept -> bool {
+        return a.m_size == b.m_size && 0 == std::memcmp(a.m_data.data(), b.m_data.data(), N);
     }
 
-    table(table&& other) noexcept
-        : table(std::move(other), other.m_values.get_allocator()) {}
+    friend auto operator!=(small_key const& a, small_key const& b) noexcept -> bool {
+        return !(a == b);
+    }
 
-    table(table&& other, allocator_type const& alloc) noexcept
-        : m_values(std::move(other.m_values), alloc)
-        , m_buckets(std::exchange(other.m_buckets, nullptr))
-        , m_num_buckets(std::exchange(other.m_num_buckets, 0))
-        , m_max_bucket_capacity(std::exchange(other.m_max_bucket_capacity, 0))
-        , m_max_load_factor(std::exchange(other.m_max_load_factor, default_max_load_factor))
-        , m_hash(std::exchange(other.m_hash, {}))
-        , m_equal(std::exchange(other.m_equal, {}))
-        , m_shifts(std::exchange(other.m_shifts, initial_shifts)) {
-        other.m_values.clear();
+    friend auto operator==(small_key const& a, std::string_view b) noexcept -> bool {
+        return a.str() == b;
     }
 
-    table(std::initializer_list<value_type> ilist,
-          size_t bucket_count = 0,
-          Hash const& hash = Hash(),
-          KeyEqual const& equal = KeyEqual(),
-          allocator_type const& alloc = allocator_type())
-        : table(bucket_count, hash, equal, alloc) {
-        insert(ilist);
+    friend auto operator==(std::string_view a, small_key const& b) noexcept -> bool {
+        return a == b.str();
     }
 
-    table(std::initializer_list<value_type> ilist, size_type bucket_count, allocator_type const& alloc)
-        : table(ilist, bucket_count, Hash(), KeyEqual(), alloc) {}
+    friend auto operator!=(small_key const& a, std::string_view b) noexcept -> bool {
+        return !(a == b);
+    }
 
-    table(std::initializer_list<value_type> init, size_type bucket_count, Hash const& hash, allocator_type const& alloc)
-        : table(init, bucket_count, hash, KeyEqual(), alloc) {}
+    friend auto operator!=(std::string_view a, small_key const& b) noexcept -> bool {
+        return !(a == b);
+    }
+};
 
-    ~table() {
-        if (nullptr != m_buckets) {
-            auto ba = bucket_alloc(m_values.get_allocator());
-            bucket_alloc_traits::deallocate(ba, m_buckets, bucket_count());
+// Same hash as std::string_view, so maps with small_key can be searched with a string_view when KeyEqual is transparent,
+// e.g. std::equal_to<>. Short keys take wyhash's path for at most 16 bytes.
+template <size_t N>
+struct hash<small_key<N>> {
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    auto operator()(small_key<N> const& key) const noexcept -> uint64_t {
+        return detail::wyhash::hash(key.data(), key.size());
+    }
+
+    auto operator()(std::string_view sv) const noexcept -> uint64_t {
+        return detail::wyhash::hash(sv.data(), sv.size());
+    }
+};
+
+// bucket_type //////////////////////////////////////////////////////////
+
+namespace bucket_type {
+
+struct standard {
+    static constexpr uint32_t dist_inc = 1U << 8U;             // skip 1 byte fingerprint
+    static constexpr uint32_t fingerprint_mask = dist_inc - 1; // mask for 1 byte of fingerprint
+
+    uint32_t m_dist_and_fingerprint; // upper 3 byte: distance to original bucket. lower byte: fingerprint from hash
+    uint32_t m_value_idx;            // index into the m_values vector.
+};
+
+ANKERL_UNORDERED_DENSE_PACK(struct big {
+    static constexpr uint32_t dist_inc = 1U << 8U;             // skip 1 byte fingerprint
+    static constexpr uint32_t fingerprint_mask = dist_inc - 1; // mask for 1 byte of fingerprint
+
+    uint32_t m_dist_and_fingerprint; // upper 3 byte: distance to original bucket. lower byte: fingerprint from hash
+    size_t m_value_idx;              // index into the m_values vector.
+});
+
+} // namespace bucket_type
+
+// relocation /////////////////////////////////////////////////////////////////
+
+// A type is trivially relocatable when moving an object to a new address and destroying the source is equivalent to a
+// memcpy. That is the case for all trivially copyable types, and for many others that don't point into themselves. Specialize
+// this for your own types to enable the memcpy fast paths of relocating_vector.
+//
+// Note that std::string is *not* trivially relocatable with libstdc++: its small string optimization stores a pointer into
+// the object itself.
+template <typename T, typename Enable = void>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <typename T, typename Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : is_trivially_relocatable<Deleter> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+template <typename A, typename B>
+struct is_trivially_relocatable<std::pair<A, B>>
+    : std::integral_constant<bool,
+                             is_trivially_relocatable_v<std::remove_cv_t<A>> && is_trivially_relocatable_v<std::remove_cv_t<B>>> {};
+
+// A std::vector replacement for the values of the map/set. When is_trivially_relocatable_v<T>, growing, erasing, and moving
+// between different allocators use memcpy instead of element-wise move construction and destruction.
+template <class T, class Allocator = std::allocator<T>>
+class relocating_vector {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "relocating_vector requires raw pointers");
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+private:
+    T* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+    Allocator m_alloc{};
+
+    // Moves n objects from src to the uninitialized dst, and ends the lifetime of the objects in src.
+    void relocate(T* src, size_t n, T* dst) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (0 != n) {
+                std::memcpy(static_cast<void*>(dst), static_cast<void const*>(src), sizeof(T) * n);
+            }
+        } else {
+            construct_from(src, n, dst, [](T& obj) -> decltype(auto) {
+                return std::move_if_noexcept(obj);
+            });
+            destroy(src, n);
         }
     }
 
-    auto operator=(table const& other) -> table& {
-        if (&other != this) {
-            deallocate_buckets(); // deallocate before m_values is set (might have another allocator)
-            m_values = other.m_values;
-            m_max_load_factor = other.m_max_load_factor;
-            m_hash = other.m_hash;
-            m_equal = other.m_equal;
-            m_shifts = initial_shifts;
-            copy_buckets(other);
+    // Constructs dst[i] from op(src[i]). When any constructor throws, the already constructed objects are destroyed.
+    template <typename Op>
+    void construct_from(T* src, size_t n, T* dst, Op op) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                alloc_traits::construct(m_alloc, dst + i, op(src[i]));
+            }
+        } catch (...) {
+            destroy(dst, i);
+            throw;
         }
-        return *this;
     }
 
-    auto operator=(table&& other) noexcept(
-        noexcept(std::is_nothrow_move_assignable_v<value_container_type>&& std::is_nothrow_move_assignable_v<Hash>&&
-                     std::is_nothrow_move_assignable_v<KeyEqual>)) -> table& {
+    void destroy(T* data, size_t n) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < n; ++i) {
+                alloc_traits::destroy(m_alloc, data + i);
+            }
+        }
+    }
+
+    void deallocate() {
+        if (nullptr != m_data) {
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+        }
+        m_data = nullptr;
+        m_capacity = 0;
+    }
+
+    void reallocate(size_t new_capacity) {
+        auto* new_data = alloc_traits::allocate(m_alloc, new_capacity);
+        try {
+            relocate(m_data, m_size, new_data);
+        } catch (...) {
+            alloc_traits::deallocate(m_alloc, new_data, new_capacity);
+            throw;
+        }
+        deallocate();
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+
+    // copies all elements of other, assumes *this is empty with enough capacity
+    void copy_elements(relocating_vector const& other) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (!other.empty()) {
+                std::memcpy(static_cast<void*>(m_data), static_cast<void const*>(other.m_data), sizeof(T) * other.m_size);
+            }
+        } else {
+            construct_from(other.m_data, other.m_size, m_data, [](T const& obj) -> T const& {
+                return obj;
+            });
+        }
+        m_size = other.m_size;
+    }
+
+    // takes over the elements of other, which might have a different allocator. other is empty afterwards.
+    void relocate_elements(relocating_vector&& other) {
+        reserve(other.m_size);
+        relocate(other.m_data, other.m_size, m_data);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+public:
+    relocating_vector() noexcept(noexcept(Allocator())) = default;
+
+    explicit relocating_vector(Allocator const& alloc) noexcept
+        : m_alloc(alloc) {}
+
+    relocating_vector(relocating_vector const& other)
+        : relocating_vector(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {}
+
+    relocating_vector(relocating_vector const& other, Allocator const& alloc)
+        : m_alloc(alloc) {
+        reserve(other.m_size);
+        copy_elements(other);
+    }
+
+    relocating_vector(relocating_vector&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+        , m_alloc(std::move(other.m_alloc)) {}
+
+    relocating_vector(relocating_vector&& other, Allocator const& alloc)
+        : m_alloc(alloc) {
+        if (m_alloc == other.m_alloc) {
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+        } else {
+            relocate_elements(std::move(other));
+        }
+    }
+
+    ~relocating_vector() {
+        clear();
+        deallocate();
+    }
+
+    auto operator=(relocating_vector const& other) -> relocating_vector& {
         if (&other != this) {
-            deallocate_buckets(); // deallocate before m_values is set (might have another allocator)
-            m_values = std::move(other.m_values);
-            m_buckets = std::exchange(other.m_buckets, nullptr);
-            m_num_buckets = std::exchange(other.m_num_buckets, 0);
-            m_max_bucket_capacity = std::exchange(other.m_max_bucket_capacity, 0);
-            m_max_load_factor = std::exchange(other.m_max_load_factor, default_max_load_factor);
-            m_hash = std::exchange(other.m_hash, {});
-            m_equal = std::exchange(other.m_equal, {});
-            m_shifts = std::exchange(other.m_shifts, initial_shifts);
-            other.m_values.clear();
+            clear();
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc != other.m_alloc) {
+                    deallocate();
+                }
+                m_alloc = other.m_alloc;
+            }
+            reserve(other.m_size);
+            copy_elements(other);
         }
         return *this;
     }
 
-    auto operator=(std::initializer_list<value_type> ilist) -> table& {
-        clear();
-        insert(ilist);
+    auto operator=(relocating_vector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                       alloc_traits::is_always_equal::value) -> relocating_vector& {
+        if (&other != this) {
+            clear();
+            if (alloc_traits::propagate_on_container_move_assignment::value || m_alloc == other.m_alloc) {
+                deallocate();
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                    m_alloc = std::move(other.m_alloc);
+                }
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+                m_capacity = std::exchange(other.m_capacity, 0);
+            } else {
+                relocate_elements(std::move(other));
+            }
+        }
         return *this;
     }
 
     auto get_allocator() const noexcept -> allocator_type {
-        return m_values.get_allocator();
+        return m_alloc;
     }
 
     // iterators //////////////////////////////////////////////////////////////
 
     auto begin() noexcept -> iterator {
-        return m_values.begin();
+        return m_data;
     }
 
     auto begin() const noexcept -> const_iterator {
-        return m_values.begin();
+        return m_data;
     }
 
     auto cbegin() const noexcept -> const_iterator {
-        return m_values.cbegin();
+        return m_data;
     }
 
     auto end() noexcept -> iterator {
-        return m_values.end();
+        return m_data + m_size;
     }
 
-    auto cend() const noexcept -> const_iterator {
-        return m_values.cend();
+    auto end() const noexcept -> const_iterator {
+        return m_data + m_size;
     }
 
-    auto end() const noexcept -> const_iterator {
-        return m_values.end();
+    auto cend() const noexcept -> const_iterator {
+        return m_data + m_size;
     }
 
     // capacity ///////////////////////////////////////////////////////////////
 
     [[nodiscard]] auto empty() const noexcept -> bool {
-        return m_values.empty();
+        return 0 == m_size;
     }
 
     [[nodiscard]] auto size() const noexcept -> size_t {
-        return m_values.size();
+        return m_size;
     }
 
-    [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
-        if constexpr (std::numeric_limits<value_idx_type>::max() == std::numeric_limits<size_t>::max()) {
-            return size_t{1} << (sizeof(value_idx_type) * 8 - 1);
-        } else {
-            return size_t{1} << (sizeof(value_idx_type) * 8);
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+        return m_capacity;
+    }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity > m_capacity) {
+            reallocate(new_capacity);
         }
     }
 
-    // modifiers //////////////////////////////////////////////////////////////
+    void shrink_to_fit() {
+        if (0 == m_size) {
+            deallocate();
+        } else if (m_size != m_capacity) {
+            reallocate(m_size);
+        }
+    }
 
-    void clear() {
-        m_values.clear();
-        clear_buckets();
+    // element access /////////////////////////////////////////////////////////
+
+    auto operator[](size_t idx) noexcept -> reference {
+        return m_data[idx];
     }
 
-    auto insert(value_type const& value) -> std::pair<iterator, bool> {
-        return emplace(value);
+    auto operator[](size_t idx) const noexcept -> const_reference {
+        return m_data[idx];
     }
 
-    auto insert(value_type&& value) -> std::pair<iterator, bool> {
-        return emplace(std::move(value));
+    auto front() noexcept -> reference {
+        return m_data[0];
     }
 
-    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, bool> = true>
-    auto insert(P&& value) -> std::pair<iterator, bool> {
-        return emplace(std::forward<P>(value));
+    auto front() const noexcept -> const_reference {
+        return m_data[0];
     }
 
-    auto insert(const_iterator /*hint*/, value_type const& value) -> iterator {
-        return insert(value).first;
+    auto back() noexcept -> reference {
+        return m_data[m_size - 1];
     }
 
-    auto insert(const_iterator /*hint*/, value_type&& value) -> iterator {
-        return insert(std::move(value)).first;
+    auto back() const noexcept -> const_reference {
+        return m_data[m_size - 1];
     }
 
-    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, bool> = true>
-    auto insert(const_iterator /*hint*/, P&& value) -> iterator {
-        return insert(std::forward<P>(value)).first;
+    auto data() noexcept -> pointer {
+        return m_data;
     }
 
-    template <class InputIt>
-    void insert(InputIt first, InputIt last) {
-        while (first != last) {
-            insert(*first);
-            ++first;
+    auto data() const noexcept -> const_pointer {
+        return m_data;
+    }
+
+    // modifiers //////////////////////////////////////////////////////////////
+
+    void clear() noexcept {
+        destroy(m_data, m_size);
+        m_size = 0;
+    }
+
+    template <class... Args>
+    auto emplace_back(Args&&... args) -> reference {
+        if (m_size == m_capacity) {
+            // construct the new element first: args might reference an element of this container
+            auto const new_capacity = 0 == m_capacity ? size_t{1} : m_capacity * 2;
+            auto* new_data = alloc_traits::allocate(m_alloc, new_capacity);
+            try {
+                alloc_traits::construct(m_alloc, new_data + m_size, std::forward<Args>(args)...);
+            } catch (...) {
+                alloc_traits::deallocate(m_alloc, new_data, new_capacity);
+                throw;
+            }
+            try {
+                relocate(m_data, m_size, new_data);
+            } catch (...) {
+                alloc_traits::destroy(m_alloc, new_data + m_size);
+                alloc_traits::deallocate(m_alloc, new_data, new_capacity);
+                throw;
+            }
+            deallocate();
+            m_data = new_data;
+            m_capacity = new_capacity;
+        } else {
+            alloc_traits::construct(m_alloc, m_data + m_size, std::forward<Args>(args)...);
         }
+        return m_data[m_size++];
     }
 
-    void insert(std::initializer_list<value_type> ilist) {
-        insert(ilist.begin(), ilist.end());
+    void push_back(T const& value) {
+        emplace_back(value);
     }
 
-    // nonstandard API: *this is emptied.
-    // Also see "A Standard flat_map" https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2022/p0429r9.pdf
-    auto extract() && -> value_container_type {
-        return std::move(m_values);
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept {
+        --m_size;
+        alloc_traits::destroy(m_alloc, m_data + m_size);
     }
 
     // nonstandard API:
-    // Discards the internally held container and replaces it with the one passed. Erases non-unique elements.
-    auto replace(value_container_type&& container) {
-        if (container.size() > max_size()) {
-            throw std::out_of_range("ankerl::unordered_dense::map::replace(): too many elements");
+    // Destroys the element at idx and relocates the last element into its place. Used by the map/set to erase elements.
+    void replace_with_back(size_t idx) {
+        auto const idx_back = m_size - 1;
+        if (idx == idx_back) {
+            pop_back();
+        } else if constexpr (is_trivially_relocatable_v<T>) {
+            alloc_traits::destroy(m_alloc, m_data + idx);
+            std::memcpy(static_cast<void*>(m_data + idx), static_cast<void const*>(m_data + idx_back), sizeof(T));
+            --m_size;
+        } else {
+            m_data[idx] = std::move(m_data[idx_back]);
+            pop_back();
         }
+    }
+};
 
-        auto shifts = calc_shifts_for_size(container.size());
-        if (0 == m_num_buckets || shifts < m_shifts || container.get_allocator() != m_values.get_allocator()) {
-            m_shifts = shifts;
-            deallocate_buckets();
-            allocate_buckets_from_shift();
-        }
-        clear_buckets();
+// arena //////////////////////////////////////////////////////////////////////
+
+// Monotonic memory for many short lived maps/sets that are all freed together. Memory is bump allocated from blocks that
+// double in size, like the bucket array and the value vector do. Deallocation is a no-op, except when the most recent
+// allocation is freed: then its memory is reused. A growing map allocates its buckets last, so on rehash the old buckets
+// are freed first and the grown values and the new buckets start where they were.
+class arena {
+    struct block {
+        block* m_prev;
+        size_t m_size; // usable bytes after this header
+    };
+
+    block* m_head = nullptr;
+    std::byte* m_pos = nullptr;
+    std::byte* m_end = nullptr;
+    size_t m_next_block_size;
+
+    [[nodiscard]] static auto begin_of(block* b) -> std::byte* {
+        return reinterpret_cast<std::byte*>(b) + sizeof(block); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    // bytes to skip so that p is aligned
+    [[nodiscard]] static auto padding(std::byte* p, size_t alignment) -> size_t {
+        auto const misalignment = reinterpret_cast<uintptr_t>(p) & (alignment - 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        return misalignment == 0 ? 0 : alignment - misalignment;
+    }
 
-        m_values = std::move(container);
+    void add_block(size_t min_bytes) {
+        auto size = std::max(m_next_block_size, min_bytes);
+        auto* b = static_cast<block*>(::operator new(sizeof(block) + size));
+        b->m_prev = m_head;
+        b->m_size = size;
+        m_head = b;
+        m_pos = begin_of(b);
+        m_end = m_pos + size;
+        m_next_block_size = size * 2;
+    }
 
-        // can't use clear_and_fill_buckets_from_values() because container elements might not be unique
-        auto value_idx = value_idx_type{};
+    void free_blocks(block* b) noexcept {
+        while (nullptr != b) {
+            auto* prev = b->m_prev;
+            ::operator delete(b);
+            b = prev;
+        }
+    }
 
-        // loop until we reach the end of the container. duplicated entries will be replaced with back().
-        while (value_idx != static_cast<value_idx_type>(m_values.size())) {
-            auto const& key = get_key(m_values[value_idx]);
+public:
+    static constexpr size_t default_initial_block_size = 4096;
 
-            auto hash = mixed_hash(key);
-            auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
-            auto bucket_idx = bucket_idx_from_hash(hash);
+    explicit arena(size_t initial_block_size = default_initial_block_size)
+        : m_next_block_size(std::max(initial_block_size, size_t{64})) {}
 
-            bool key_found = false;
-            while (true) {
-                auto const& bucket = at(m_buckets, bucket_idx);
-                if (dist_and_fingerprint > bucket.m_dist_and_fingerprint) {
-                    break;
-                }
-                if (dist_and_fingerprint == bucket.m_dist_and_fingerprint &&
-                    m_equal(key, m_values[bucket.m_value_idx].first)) {
-                    key_found = true;
-                    break;
-                }
-                dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-                bucket_idx = next(bucket_idx);
-            }
+    arena(arena const&) = delete;
+    auto operator=(arena const&) -> arena& = delete;
+    arena(arena&&) = delete;
+    auto operator=(arena&&) -> arena& = delete;
 
-            if (key_found) {
-                if (value_idx != static_cast<value_idx_type>(m_values.size() - 1)) {
-                    m_values[value_idx] = std::move(m_values.back());
-                }
-                m_values.pop_back();
-            } else {
-                place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
-                ++value_idx;
-            }
+    ~arena() {
+        free_blocks(m_head);
+    }
+
+    [[nodiscard]] auto allocate(size_t bytes, size_t alignment) -> void* {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(bytes > std::numeric_limits<size_t>::max() / 2 - sizeof(block) - alignment)) {
+            throw std::bad_alloc();
         }
+        if (nullptr == m_pos || static_cast<size_t>(m_end - m_pos) < padding(m_pos, alignment) + bytes) {
+            add_block(bytes + alignment);
+        }
+        auto* p = m_pos + padding(m_pos, alignment);
+        m_pos = p + bytes;
+        return p;
     }
 
-    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto insert_or_assign(Key const& key, M&& mapped) -> std::pair<iterator, bool> {
-        return do_insert_or_assign(key, std::forward<M>(mapped));
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (static_cast<std::byte*>(p) + bytes == m_pos) {
+            m_pos = static_cast<std::byte*>(p);
+        }
     }
 
-    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto insert_or_assign(Key&& key, M&& mapped) -> std::pair<iterator, bool> {
-        return do_insert_or_assign(std::move(key), std::forward<M>(mapped));
+    // Makes all memory available again, but keeps the biggest block so the next round of maps doesn't need to allocate.
+    // All containers using this arena must be destroyed (or not used any more) before.
+    void reset() noexcept {
+        if (nullptr != m_head) {
+            free_blocks(std::exchange(m_head->m_prev, nullptr));
+            m_pos = begin_of(m_head);
+            m_end = m_pos + m_head->m_size;
+        }
     }
 
-    template <typename K,
-              typename M,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto insert_or_assign(K&& key, M&& mapped) -> std::pair<iterator, bool> {
-        return do_insert_or_assign(std::forward<K>(key), std::forward<M>(mapped));
+    // Frees all blocks.
+    void release() noexcept {
+        free_blocks(std::exchange(m_head, nullptr));
+        m_pos = nullptr;
+        m_end = nullptr;
     }
 
-    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto insert_or_assign(const_iterator /*hint*/, Key const& key, M&& mapped) -> iterator {
-        return do_insert_or_assign(key, std::forward<M>(mapped)).first;
+    // Number of bytes of all blocks currently held
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+        auto bytes = size_t{};
+        for (auto const* b = m_head; nullptr != b; b = b->m_prev) {
+            bytes += b->m_size;
+        }
+        return bytes;
     }
 
-    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    // Number of bytes that are allocated, or were skipped because they didn't fit at the end of a block
+    [[nodiscard]] auto used() const noexcept -> size_t {
+        if (nullptr == m_head) {
+            return 0;
+        }
+        return capacity() - static_cast<size_t>(m_end - m_pos);
+    }
+};
+
+// Allocator that gets all memory from an arena. deallocate() doesn't free anything, the memory is released all at once
+// with arena::reset() or arena::release().
+template <class T>
+class arena_allocator {
+    template <class U>
+    friend class arena_allocator;
+
+    arena* m_arena;
+
+public:
+    using value_type = T;
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    arena_allocator(arena& a) noexcept
+        : m_arena(&a) {}
+
+    template <class U>
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    arena_allocator(arena_allocator<U> const& other) noexcept
+        : m_arena(other.m_arena) {}
+
+    [[nodiscard]] auto allocate(size_t n) -> T* {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        m_arena->deallocate(p, n * sizeof(T));
+    }
+
+    [[nodiscard]] auto get_arena() const noexcept -> arena& {
+        return *m_arena;
+    }
+
+    template <class U>
+    [[nodiscard]] auto operator==(arena_allocator<U> const& other) const noexcept -> bool {
+        return m_arena == other.m_arena;
+    }
+
+    template <class U>
+    [[nodiscard]] auto operator!=(arena_allocator<U> const& other) const noexcept -> bool {
+        return m_arena != other.m_arena;
+    }
+};
+
+// bucket recycler ////////////////////////////////////////////////////////////
+
+// While a bucket_recycler is alive, maps/sets using std::allocator on this thread don't free their bucket arrays but hand
+// them to the recycler, and take them from there when a new bucket array of the same size is needed. Bucket counts are
+// powers of two, so workloads that create and destroy many maps of similar size mostly reuse arrays instead of calling
+// malloc/free. Reused arrays are not zeroed here, the map always overwrites all buckets after allocation.
+// Recyclers can be nested, the innermost one is used. Cached arrays are freed when the recycler is destroyed.
+class bucket_recycler {
+    struct entry {
+        void* m_ptr;
+        size_t m_bytes;
+    };
+
+    std::vector<entry> m_entries{};
+    size_t m_max_cached_arrays;
+    size_t m_max_array_bytes;
+    bucket_recycler* m_prev;
+
+    static auto current_ref() noexcept -> bucket_recycler*& {
+        static thread_local bucket_recycler* current = nullptr;
+        return current;
+    }
+
+    static void free_array(void* ptr, size_t bytes) noexcept {
+        std::allocator<std::byte>().deallocate(static_cast<std::byte*>(ptr), bytes);
+    }
+
+public:
+    static constexpr size_t default_max_cached_arrays = 64;
+    static constexpr size_t default_max_array_bytes = size_t{1} << 20U;
+
+    explicit bucket_recycler(size_t max_cached_arrays = default_max_cached_arrays,
+                             size_t max_array_bytes = default_max_array_bytes)
+        : m_max_cached_arrays(max_cached_arrays)
+        , m_max_array_bytes(max_array_bytes)
+        , m_prev(std::exchange(current_ref(), this)) {
+        m_entries.reserve(m_max_cached_arrays);
+    }
+
+    bucket_recycler(bucket_recycler const&) = delete;
+    auto operator=(bucket_recycler const&) -> bucket_recycler& = delete;
+    bucket_recycler(bucket_recycler&&) = delete;
+    auto operator=(bucket_recycler&&) -> bucket_recycler& = delete;
+
+    ~bucket_recycler() {
+        current_ref() = m_prev;
+        for (auto const& e : m_entries) {
+            free_array(e.m_ptr, e.m_bytes);
+        }
+    }
+
+    // The active recycler of this thread, or nullptr
+    [[nodiscard]] static auto current() noexcept -> bucket_recycler* {
+        return current_ref();
+    }
+
+    // Returns a cached array of exactly this size, or nullptr
+    [[nodiscard]] auto take(size_t bytes) noexcept -> void* {
+        for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+            if (it->m_bytes == bytes) {
+                auto* ptr = it->m_ptr;
+                *it = m_entries.back();
+                m_entries.pop_back();
+                return ptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Takes ownership of an array that was allocated with std::allocator and has at most __STDCPP_DEFAULT_NEW_ALIGNMENT__.
+    // Returns false when it is not cached, then the caller has to free it.
+    [[nodiscard]] auto give(void* ptr, size_t bytes) noexcept -> bool {
+        if (bytes > m_max_array_bytes || m_entries.size() == m_max_cached_arrays) {
+            return false;
+        }
+        m_entries.push_back({ptr, bytes}); // can't throw, capacity is reserved
+        return true;
+    }
+
+    // Number of arrays currently cached
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return m_entries.size();
+    }
+};
+
+// table stats ////////////////////////////////////////////////////////////////
+
+// Snapshot of how well the elements are spread over the buckets, see table::stats(). With a good hash the mean probe length
+// stays below about 3 up to the default max_load_factor, and the fingerprint collision rate is well below
+// 1 / (fingerprint_mask + 1): only elements with the same home bucket can collide.
+struct table_stats {
+    std::vector<size_t> distance_histogram{}; // [d]: number of elements that are d buckets after their home bucket
+    size_t num_elements = 0;
+    size_t num_buckets = 0;
+    size_t max_probe_length = 0;             // buckets that a successful lookup checks, in the worst case
+    double mean_probe_length = 0.0;          // buckets that a successful lookup checks, on average
+    double occupancy = 0.0;                  // num_elements / num_buckets
+    size_t fingerprint_collisions = 0;       // key comparisons with a different key when each element is looked up once
+    double fingerprint_collision_rate = 0.0; // fingerprint_collisions per checked bucket of another element
+    size_t bucket_bytes = 0;                 // memory of the buckets
+    size_t value_bytes = 0;                  // memory of the values container's capacity, without memory owned by the values
+};
+
+#    if ANKERL_UNORDERED_DENSE_STATS
+
+// Counts of what the table did since construction or the last reset_counters(). Only available when compiled with
+// ANKERL_UNORDERED_DENSE_STATS, see table::counters().
+struct table_counters {
+    uint64_t finds = 0;                       // lookups with find(), contains(), count(), at()
+    uint64_t find_hits = 0;                   // finds where the key was found
+    uint64_t find_misses = 0;                 // finds where the key was not found
+    uint64_t probe_steps = 0;                 // buckets checked by finds
+    uint64_t key_compares = 0;                // calls of KeyEqual, by all operations
+    uint64_t fingerprint_false_positives = 0; // calls of KeyEqual that returned false
+    uint64_t shift_ups = 0;                   // buckets moved up to make room for an inserted element, not by rehashes
+    uint64_t erase_shifts = 0;                // buckets moved down by the backward shift of an erase
+    uint64_t rehashes = 0;                    // number of times all buckets were rebuilt from the values
+    uint64_t bytes_allocated = 0; // bytes of all bucket arrays that were allocated or taken from a recycler, and of all
+                                  // arrays the values container allocated to grow, shrink or copy
+};
+
+namespace detail {
+
+// Counts of a single find. They are collected in locals and added to the table's counters once when the find returns.
+struct find_counts {
+    uint64_t probe_steps = 0;
+    uint64_t key_compares = 0;
+    uint64_t fingerprint_false_positives = 0;
+
+    void add_probe_step() noexcept {
+        ++probe_steps;
+    }
+
+    template <typename KeyEqual, typename K, typename Other>
+    [[nodiscard]] auto key_equals(KeyEqual const& equal, K const& key, Other const& other) -> bool {
+        ++key_compares;
+        auto const is_equal = equal(key, other);
+        fingerprint_false_positives += is_equal ? 0U : 1U;
+        return is_equal;
+    }
+};
+
+// The table's storage of table_counters. const lookups update them, and these can run concurrently on a shared table, so
+// the counters are atomics. An update is a relaxed load and store instead of a locked read-modify-write, so it costs the
+// same as a plain increment. When several threads use the same table at the same time, some of their updates can get
+// lost, then the counters are a lower bound.
+struct atomic_table_counters {
+    std::atomic<uint64_t> finds{};
+    std::atomic<uint64_t> find_hits{};
+    std::atomic<uint64_t> find_misses{};
+    std::atomic<uint64_t> probe_steps{};
+    std::atomic<uint64_t> key_compares{};
+    std::atomic<uint64_t> fingerprint_false_positives{};
+    std::atomic<uint64_t> shift_ups{};
+    std::atomic<uint64_t> erase_shifts{};
+    std::atomic<uint64_t> rehashes{};
+    std::atomic<uint64_t> bytes_allocated{};
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // one update per counter and find, no matter how many buckets it checked
+    void add_find(find_counts const& counts, bool is_hit) noexcept {
+        add(finds, 1);
+        add(is_hit ? find_hits : find_misses, 1);
+        if (0 != counts.probe_steps) {
+            add(probe_steps, counts.probe_steps);
+        }
+        add_key_compares(counts);
+    }
+
+    void add_key_compares(find_counts const& counts) noexcept {
+        if (0 != counts.key_compares) {
+            add(key_compares, counts.key_compares);
+        }
+        if (0 != counts.fingerprint_false_positives) {
+            add(fingerprint_false_positives, counts.fingerprint_false_positives);
+        }
+    }
+
+    [[nodiscard]] auto load() const noexcept -> table_counters {
+        auto const get = [](std::atomic<uint64_t> const& counter) {
+            return counter.load(std::memory_order_relaxed);
+        };
+        return {get(finds),
+                get(find_hits),
+                get(find_misses),
+                get(probe_steps),
+                get(key_compares),
+                get(fingerprint_false_positives),
+                get(shift_ups),
+                get(erase_shifts),
+                get(rehashes),
+                get(bytes_allocated)};
+    }
+
+    void reset() noexcept {
+        for (auto* counter : {&finds,
+                              &find_hits,
+                              &find_misses,
+                              &probe_steps,
+                              &key_compares,
+                              &fingerprint_false_positives,
+                              &shift_ups,
+                              &erase_shifts,
+                              &rehashes,
+                              &bytes_allocated}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace detail
+
+#    else
+
+namespace detail {
+
+// Without counters, find_counts does nothing
+struct find_counts {
+    static void add_probe_step() noexcept {}
+
+    template <typename KeyEqual, typename K, typename Other>
+    [[nodiscard]] static auto key_equals(KeyEqual const& equal, K const& key, Other const& other) -> bool {
+        return equal(key, other);
+    }
+};
+
+} // namespace detail
+
+#    endif
+
+// observer ///////////////////////////////////////////////////////////////////
+
+// The buckets were reallocated and all elements were placed again: when the table grows, in reserve(), rehash() and
+// replace(), and when a copy assignment copies the buckets of the other table.
+struct rehash_event {
+    size_t old_bucket_count;
+    size_t new_bucket_count;
+    size_t size;
+    std::chrono::nanoseconds duration; // of the whole rehash: freeing and allocating the buckets, and placing all elements
+};
+
+// The values container increased its capacity: when an element was added, in reserve(), or when a copy assignment needed
+// more capacity than the table had. Copy construction allocates the first values container and is not reported.
+struct values_growth_event {
+    size_t old_capacity;
+    size_t new_capacity;
+    size_t size;
+    std::chrono::nanoseconds duration; // of the emplace_back() or reserve() that grew the container
+};
+
+// Observer policy: the last template argument of map / set. Its static functions are called after each rehash and each
+// capacity growth of the values container. An observer with `static constexpr bool is_enabled = false` gets no calls, and
+// the table doesn't even look at the clock. That's the case for the default no_observer.
+struct no_observer {
+    static constexpr bool is_enabled = false;
+
+    static void on_rehash(rehash_event const& /*event*/) noexcept {}
+    static void on_values_growth(values_growth_event const& /*event*/) noexcept {}
+};
+
+// Emits the USDT probes ankerl_unordered_dense:rehash(old_bucket_count, new_bucket_count, size, duration_ns) and
+// ankerl_unordered_dense:values_growth(old_capacity, new_capacity, size, duration_ns), e.g. for bpftrace or perf. Does
+// nothing when <sys/sdt.h> isn't available, then it is disabled and there is no timing overhead either.
+struct usdt_observer {
+    static constexpr bool is_enabled = ANKERL_UNORDERED_DENSE_HAS_USDT != 0;
+
+    static void on_rehash([[maybe_unused]] rehash_event const& event) noexcept {
+#    if ANKERL_UNORDERED_DENSE_HAS_USDT
+        DTRACE_PROBE4(ankerl_unordered_dense,
+                      rehash,
+                      event.old_bucket_count,
+                      event.new_bucket_count,
+                      event.size,
+                      static_cast<int64_t>(event.duration.count()));
+#    endif
+    }
+
+    static void on_values_growth([[maybe_unused]] values_growth_event const& event) noexcept {
+#    if ANKERL_UNORDERED_DENSE_HAS_USDT
+        DTRACE_PROBE4(ankerl_unordered_dense,
+                      values_growth,
+                      event.old_capacity,
+                      event.new_capacity,
+                      event.size,
+                      static_cast<int64_t>(event.duration.count()));
+#    endif
+    }
+};
+
+// memory usage ///////////////////////////////////////////////////////////////
+
+// Memory held by a table, see table::memory_usage(). The table object itself (sizeof) is not included.
+struct table_memory {
+    size_t bucket_bytes = 0;           // allocated buckets
+    size_t values_capacity_bytes = 0;  // allocated by the values container, capacity() * sizeof(value_type)
+    size_t values_bytes = 0;           // used by the elements, size() * sizeof(value_type)
+    size_t heap_bytes = 0;             // owned by the keys and values themselves, as reported by heap_size
+    size_t total_bytes = 0;            // bucket_bytes + values_capacity_bytes + heap_bytes
+    double overhead_per_element = 0.0; // bytes of buckets and unused values capacity per element
+};
+
+// Customization point for table::memory_usage(): specialize it with a `auto operator()(T const&) const noexcept ->
+// size_t` that returns the bytes an object owns outside of itself. It has to be noexcept, because memory_usage() is.
+// Types without a specialization own nothing, then memory_usage() doesn't need to look at the elements.
+template <typename T, typename Enable = void>
+struct heap_size {};
+
+namespace detail {
+
+template <typename T>
+constexpr bool has_heap_size = std::is_invocable_r_v<size_t, heap_size<T> const&, T const&>;
+
+template <typename T>
+[[nodiscard]] auto heap_size_of(T const& obj) noexcept -> size_t {
+    if constexpr (has_heap_size<T>) {
+        static_assert(noexcept(heap_size<T>{}(obj)), "heap_size<T>::operator() must be noexcept");
+        return heap_size<T>{}(obj);
+    } else {
+        return 0;
+    }
+}
+
+} // namespace detail
+
+template <class CharT, class Traits, class Allocator>
+struct heap_size<std::basic_string<CharT, Traits, Allocator>> {
+    auto operator()(std::basic_string<CharT, Traits, Allocator> const& str) const noexcept -> size_t {
+        // short strings are stored within the string object
+        auto const data = reinterpret_cast<uintptr_t>(str.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto const self = reinterpret_cast<uintptr_t>(&str);       // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (data >= self && data < self + sizeof(str)) {
+            return 0;
+        }
+        return (str.capacity() + 1) * sizeof(CharT);
+    }
+};
+
+template <class T, class Allocator>
+struct heap_size<std::vector<T, Allocator>> {
+    auto operator()(std::vector<T, Allocator> const& vec) const noexcept -> size_t {
+        if constexpr (std::is_same_v<T, bool>) {
+            // std::vector<bool> stores bits, its capacity() is in bits
+            return (vec.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+        }
+        auto bytes = vec.capacity() * sizeof(T);
+        if constexpr (detail::has_heap_size<T>) {
+            for (auto const& obj : vec) {
+                bytes += detail::heap_size_of(obj);
+            }
+        }
+        return bytes;
+    }
+};
+
+namespace detail {
+
+struct nonesuch {};
+
+template <class Default, class AlwaysVoid, template <class...> class Op, class... Args>
+struct detector {
+    using value_t = std::false_type;
+    using type = Default;
+};
+
+template <class Default, template <class...> class Op, class... Args>
+struct detector<Default, std::void_t<Op<Args...>>, Op, Args...> {
+    using value_t = std::true_type;
+    using type = Op<Args...>;
+};
+
+template <template <class...> class Op, class... Args>
+using is_detected = typename detail::detector<detail::nonesuch, void, Op, Args...>::value_t;
+
+template <template <class...> class Op, class... Args>
+constexpr bool is_detected_v = is_detected<Op, Args...>::value;
+
+template <typename T>
+using detect_avalanching = typename T::is_avalanching;
+
+template <typename T>
+using detect_is_transparent = typename T::is_transparent;
+
+template <typename T>
+using detect_iterator = typename T::iterator;
+
+template <typename T>
+using detect_reserve = decltype(std::declval<T&>().reserve(size_t{}));
+
+template <typename T>
+using detect_replace_with_back = decltype(std::declval<T&>().replace_with_back(size_t{}));
+
+template <typename T>
+using detect_static_capacity = decltype(T::static_capacity);
+
+template <typename T>
+using detect_capacity = decltype(std::declval<T const&>().capacity());
+
+template <typename T>
+using detect_is_enabled = decltype(T::is_enabled);
+
+// enable_if helpers
+
+template <typename Mapped>
+constexpr bool is_map_v = !std::is_void_v<Mapped>;
+
+// clang-format off
+template <typename Hash, typename KeyEqual>
+constexpr bool is_transparent_v = is_detected_v<detect_is_transparent, Hash>&& is_detected_v<detect_is_transparent, KeyEqual>;
+// clang-format on
+
+template <typename From, typename To1, typename To2>
+constexpr bool is_neither_convertible_v = !std::is_convertible_v<From, To1> && !std::is_convertible_v<From, To2>;
+
+template <typename T>
+constexpr bool has_reserve = is_detected_v<detect_reserve, T>;
+
+// observers without is_enabled are always enabled
+template <typename Observer>
+[[nodiscard]] constexpr auto is_enabled_observer() -> bool {
+    if constexpr (is_detected_v<detect_is_enabled, Observer>) {
+        return Observer::is_enabled;
+    } else {
+        return true;
+    }
+}
+
+template <typename T>
+constexpr bool has_replace_with_back = is_detected_v<detect_replace_with_back, T>;
+
+template <typename T>
+constexpr bool has_static_capacity = is_detected_v<detect_static_capacity, T>;
+
+template <typename T>
+constexpr bool has_capacity = is_detected_v<detect_capacity, T>;
+
+template <typename T>
+[[nodiscard]] constexpr auto static_capacity_of() -> size_t {
+    if constexpr (has_static_capacity<T>) {
+        return T::static_capacity;
+    } else {
+        return 0;
+    }
+}
+
+// Shifts for the smallest power of two number of buckets that can hold capacity elements with the given max_load_factor
+[[nodiscard]] constexpr auto calc_static_shifts(size_t capacity, uint8_t shifts, float max_load_factor) -> uint8_t {
+    while (static_cast<float>(size_t{1} << (64U - shifts)) * max_load_factor < static_cast<float>(capacity)) {
+        --shifts;
+    }
+    return shifts;
+}
+
+// Fixed capacity container that stores all values inline, so it never allocates. Value container of static_map and
+// static_set.
+template <class T, size_t N>
+class static_vector {
+    static_assert(N > 0, "static_vector needs a capacity");
+
+public:
+    static constexpr size_t static_capacity = N;
+
+    using value_type = T;
+    using allocator_type = std::allocator<T>; // never used to allocate anything
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+private:
+    alignas(T) std::array<std::byte, sizeof(T) * N> m_storage;
+    size_t m_size = 0;
+
+    [[nodiscard]] auto ptr(size_t idx) noexcept -> T* {
+        return reinterpret_cast<T*>(m_storage.data()) + idx; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    [[nodiscard]] auto ptr(size_t idx) const noexcept -> T const* {
+        return reinterpret_cast<T const*>(m_storage.data()) + idx; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    template <typename Other>
+    void append_all(Other&& other) {
+        for (auto& val : other) {
+            if constexpr (std::is_rvalue_reference_v<Other&&>) {
+                emplace_back(std::move(val));
+            } else {
+                emplace_back(val);
+            }
+        }
+    }
+
+public:
+    static_vector() noexcept {} // NOLINT(modernize-use-equals-default,cppcoreguidelines-pro-type-member-init)
+
+    explicit static_vector(allocator_type const& /*alloc*/) noexcept
+        : static_vector() {}
+
+    static_vector(static_vector const& other)
+        : static_vector() {
+        append_all(other);
+    }
+
+    static_vector(static_vector const& other, allocator_type const& /*alloc*/)
+        : static_vector(other) {}
+
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : static_vector() {
+        append_all(std::move(other));
+        other.clear();
+    }
+
+    static_vector(static_vector&& other, allocator_type const& /*alloc*/) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : static_vector(std::move(other)) {}
+
+    ~static_vector() {
+        clear();
+    }
+
+    auto operator=(static_vector const& other) -> static_vector& {
+        if (&other != this) {
+            clear();
+            append_all(other);
+        }
+        return *this;
+    }
+
+    auto operator=(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) -> static_vector& {
+        if (&other != this) {
+            clear();
+            append_all(std::move(other));
+            other.clear();
+        }
+        return *this;
+    }
+
+    auto get_allocator() const noexcept -> allocator_type {
+        return {};
+    }
+
+    auto begin() noexcept -> iterator {
+        return ptr(0);
+    }
+
+    auto begin() const noexcept -> const_iterator {
+        return ptr(0);
+    }
+
+    auto cbegin() const noexcept -> const_iterator {
+        return ptr(0);
+    }
+
+    auto end() noexcept -> iterator {
+        return ptr(m_size);
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return ptr(m_size);
+    }
+
+    auto cend() const noexcept -> const_iterator {
+        return ptr(m_size);
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return 0 == m_size;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return m_size;
+    }
+
+    [[nodiscard]] static constexpr auto capacity() noexcept -> size_t {
+        return N;
+    }
+
+    void reserve(size_t new_capacity) const {
+        if (new_capacity > N) {
+            throw std::overflow_error("ankerl::unordered_dense::static_vector: capacity exceeded");
+        }
+    }
+
+    void shrink_to_fit() noexcept {}
+
+    auto operator[](size_t idx) noexcept -> reference {
+        return *ptr(idx);
+    }
+
+    auto operator[](size_t idx) const noexcept -> const_reference {
+        return *ptr(idx);
+    }
+
+    auto back() noexcept -> reference {
+        return *ptr(m_size - 1);
+    }
+
+    auto back() const noexcept -> const_reference {
+        return *ptr(m_size - 1);
+    }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < m_size; ++i) {
+                ptr(i)->~T();
+            }
+        }
+        m_size = 0;
+    }
+
+    template <class... Args>
+    auto emplace_back(Args&&... args) -> reference {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(m_size == N)) {
+            throw std::overflow_error("ankerl::unordered_dense::static_vector: capacity exceeded");
+        }
+        auto* obj = ::new (static_cast<void*>(ptr(m_size))) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *obj;
+    }
+
+    void pop_back() noexcept {
+        --m_size;
+        ptr(m_size)->~T();
+    }
+
+    // nonstandard API:
+    // Destroys the element at idx and relocates the last element into its place. Used by the map/set to erase elements.
+    void replace_with_back(size_t idx) {
+        auto const idx_back = m_size - 1;
+        if (idx == idx_back) {
+            pop_back();
+        } else if constexpr (is_trivially_relocatable_v<T>) {
+            ptr(idx)->~T();
+            std::memcpy(static_cast<void*>(ptr(idx)), static_cast<void const*>(ptr(idx_back)), sizeof(T));
+            --m_size;
+        } else {
+            *ptr(idx) = std::move(*ptr(idx_back));
+            pop_back();
+        }
+    }
+};
+
+// base type for map has mapped_type
+template <class T>
+struct base_table_type_map {
+    using mapped_type = T;
+};
+
+// base type for set doesn't have mapped_type
+struct base_table_type_set {};
+
+// This is it, the table. Doubles as map and set, and uses `void` for T when its used as a set.
+template <class Key,
+          class T, // when void, treat it as a set.
+          class Hash,
+          class KeyEqual,
+          class AllocatorOrContainer,
+          class Bucket,
+          class Observer>
+class table : public std::conditional_t<is_map_v<T>, base_table_type_map<T>, base_table_type_set> {
+public:
+    using value_container_type = std::conditional_t<
+        is_detected_v<detect_iterator, AllocatorOrContainer>,
+        AllocatorOrContainer,
+        typename std::vector<typename std::conditional_t<is_map_v<T>, std::pair<Key, T>, Key>, AllocatorOrContainer>>;
+
+private:
+    using bucket_alloc =
+        typename std::allocator_traits<typename value_container_type::allocator_type>::template rebind_alloc<Bucket>;
+    using bucket_alloc_traits = std::allocator_traits<bucket_alloc>;
+    using bucket_pointer = typename std::allocator_traits<bucket_alloc>::pointer;
+    // only std::allocator bucket arrays can be handed to the bucket_recycler. It frees them as plain bytes and reuses them
+    // for other bucket types, so over-aligned buckets (allocated with aligned new) are never cached.
+    static constexpr bool is_recyclable = std::is_same_v<bucket_alloc, std::allocator<Bucket>> &&
+                                          alignof(Bucket) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr bool is_arena_allocated = std::is_same_v<bucket_alloc, arena_allocator<Bucket>>;
+
+    static constexpr uint8_t initial_shifts = 64 - 3; // 2^(64-m_shift) number of buckets
+    static constexpr float default_max_load_factor = 0.8F;
+
+    // A container with static capacity (see static_map) makes the table allocation free: the buckets are stored inline too.
+    // Their number is limited to the smallest power of two that fits all values with the default max_load_factor.
+    static constexpr bool is_static = has_static_capacity<value_container_type>;
+    static constexpr uint8_t min_shifts =
+        is_static ? calc_static_shifts(static_capacity_of<value_container_type>(), initial_shifts, default_max_load_factor) : 0;
+
+    using static_buckets = std::array<Bucket, is_static ? size_t{1} << (64U - min_shifts) : 0>;
+
+    // only an enabled observer gets timings, so there's no clock access in the default case
+    static constexpr bool is_observed = is_enabled_observer<Observer>();
+    // counters need to see growth of the values container too, for bytes_allocated
+    static constexpr bool is_counted = ANKERL_UNORDERED_DENSE_STATS != 0;
+
+public:
+    using key_type = Key;
+    using value_type = typename value_container_type::value_type;
+    using size_type = typename value_container_type::size_type;
+    using difference_type = typename value_container_type::difference_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = typename value_container_type::allocator_type;
+    using reference = typename value_container_type::reference;
+    using const_reference = typename value_container_type::const_reference;
+    using pointer = typename value_container_type::pointer;
+    using const_pointer = typename value_container_type::const_pointer;
+    using const_iterator = typename value_container_type::const_iterator;
+    using iterator = std::conditional_t<is_map_v<T>, typename value_container_type::iterator, const_iterator>;
+    using bucket_type = Bucket;
+
+private:
+    using value_idx_type = decltype(Bucket::m_value_idx);
+    using dist_and_fingerprint_type = decltype(Bucket::m_dist_and_fingerprint);
+
+    static_assert(std::is_trivially_destructible_v<Bucket>, "assert there's no need to call destructor / std::destroy");
+    static_assert(std::is_trivially_copyable_v<Bucket>, "assert we can just memset / memcpy");
+
+    value_container_type m_values{}; // Contains all the key-value pairs in one densely stored container. No holes.
+    std::conditional_t<is_static, static_buckets, bucket_pointer> m_buckets{};
+    size_t m_num_buckets = 0;
+    size_t m_max_bucket_capacity = 0;
+    float m_max_load_factor = default_max_load_factor;
+    Hash m_hash{};
+    KeyEqual m_equal{};
+    uint8_t m_shifts = initial_shifts;
+#    if ANKERL_UNORDERED_DENSE_STATS
+    mutable detail::atomic_table_counters m_counters{};
+#    endif
+
+    [[nodiscard]] auto next(value_idx_type bucket_idx) const -> value_idx_type {
+        return ANKERL_UNORDERED_DENSE_UNLIKELY(bucket_idx + 1U == m_num_buckets)
+                   ? 0
+                   : static_cast<value_idx_type>(bucket_idx + 1U);
+    }
+
+    // Helper to access bucket through pointer types
+    [[nodiscard]] static constexpr auto at(bucket_pointer bucket_ptr, size_t offset) -> Bucket& {
+        return *(bucket_ptr + static_cast<typename std::allocator_traits<bucket_alloc>::difference_type>(offset));
+    }
+
+    [[nodiscard]] static constexpr auto at(static_buckets& buckets, size_t offset) -> Bucket& {
+        return buckets[offset];
+    }
+
+    [[nodiscard]] static constexpr auto at(static_buckets const& buckets, size_t offset) -> Bucket const& {
+        return buckets[offset];
+    }
+
+    // use the dist_inc and dist_dec functions so that uint16_t types work without warning
+    [[nodiscard]] static constexpr auto dist_inc(dist_and_fingerprint_type x) -> dist_and_fingerprint_type {
+        return static_cast<dist_and_fingerprint_type>(x + Bucket::dist_inc);
+    }
+
+    [[nodiscard]] static constexpr auto dist_dec(dist_and_fingerprint_type x) -> dist_and_fingerprint_type {
+        return static_cast<dist_and_fingerprint_type>(x - Bucket::dist_inc);
+    }
+
+    // The goal of mixed_hash is to always produce a high quality 64bit hash.
+    template <typename K>
+    [[nodiscard]] constexpr auto mixed_hash(K const& key) const -> uint64_t {
+        if constexpr (is_detected_v<detect_avalanching, Hash>) {
+            // we know that the hash is good because is_avalanching.
+            if constexpr (sizeof(decltype(m_hash(key))) < sizeof(uint64_t)) {
+                // 32bit hash and is_avalanching => multiply with a constant to avalanche bits upwards
+                return m_hash(key) * UINT64_C(0x9ddfea08eb382d69);
+            } else {
+                // 64bit and is_avalanching => only use the hash itself.
+                return m_hash(key);
+            }
+        } else {
+            // not is_avalanching => apply wyhash
+            return wyhash::hash(m_hash(key));
+        }
+    }
+
+    [[nodiscard]] constexpr auto dist_and_fingerprint_from_hash(uint64_t hash) const -> dist_and_fingerprint_type {
+        return Bucket::dist_inc | (static_cast<dist_and_fingerprint_type>(hash) & Bucket::fingerprint_mask);
+    }
+
+    [[nodiscard]] constexpr auto bucket_idx_from_hash(uint64_t hash) const -> value_idx_type {
+        return static_cast<value_idx_type>(hash >> m_shifts);
+    }
+
+    [[nodiscard]] static constexpr auto get_key(value_type const& vt) -> key_type const& {
+        if constexpr (is_map_v<T>) {
+            return vt.first;
+        } else {
+            return vt;
+        }
+    }
+
+    template <typename K>
+    [[nodiscard]] auto next_while_less(K const& key) const -> Bucket {
+        auto hash = mixed_hash(key);
+        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
+        auto bucket_idx = bucket_idx_from_hash(hash);
+
+        while (dist_and_fingerprint < at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+        }
+        return {dist_and_fingerprint, bucket_idx};
+    }
+
+    // compares key with a key that has the same dist_and_fingerprint, so false means a fingerprint false positive
+    template <typename K, typename Other>
+    [[nodiscard]] auto key_equals(K const& key, Other const& other) const -> bool {
+#    if ANKERL_UNORDERED_DENSE_STATS
+        auto counts = detail::find_counts();
+        auto const is_equal = counts.key_equals(m_equal, key, other);
+        m_counters.add_key_compares(counts);
+        return is_equal;
+#    else
+        return detail::find_counts::key_equals(m_equal, key, other);
+#    endif
+    }
+
+    // is_insert is false when a rehash places all elements again, its moves are not counted as shift_ups
+    void place_and_shift_up(Bucket bucket, value_idx_type place, bool is_insert = true) {
+        while (0 != at(m_buckets, place).m_dist_and_fingerprint) {
+            if (is_insert) {
+                ANKERL_UNORDERED_DENSE_COUNT(shift_ups, 1);
+            }
+            bucket = std::exchange(at(m_buckets, place), bucket);
+            bucket.m_dist_and_fingerprint = dist_inc(bucket.m_dist_and_fingerprint);
+            place = next(place);
+        }
+        at(m_buckets, place) = bucket;
+    }
+
+    [[nodiscard]] static constexpr auto calc_num_buckets(uint8_t shifts) -> size_t {
+        return std::min(max_bucket_count(), size_t{1} << (64U - shifts));
+    }
+
+    [[nodiscard]] constexpr auto calc_shifts_for_size(size_t s) const -> uint8_t {
+        auto shifts = initial_shifts;
+        while (shifts > min_shifts && static_cast<size_t>(static_cast<float>(calc_num_buckets(shifts)) * max_load_factor()) < s) {
+            --shifts;
+        }
+        return shifts;
+    }
+
+    // assumes m_values has data, m_buckets=m_buckets_end=nullptr, m_shifts is INITIAL_SHIFTS
+    void copy_buckets(table const& other) {
+        if (!empty()) {
+            m_shifts = other.m_shifts;
+            allocate_buckets_from_shift();
+            std::memcpy(&at(m_buckets, 0), &at(other.m_buckets, 0), sizeof(Bucket) * bucket_count());
+        }
+    }
+
+    /**
+     * True when no element can be added any more without increasing the size
+     */
+    [[nodiscard]] auto is_full() const -> bool {
+        return size() >= m_max_bucket_capacity;
+    }
+
+    void deallocate_buckets() {
+        if constexpr (!is_static) {
+            if (nullptr != m_buckets) {
+                if constexpr (is_recyclable) {
+                    auto* recycler = bucket_recycler::current();
+                    if (nullptr != recycler && recycler->give(m_buckets, sizeof(Bucket) * bucket_count())) {
+                        m_buckets = nullptr;
+                    }
+                }
+                if (nullptr != m_buckets) {
+                    auto ba = bucket_alloc(m_values.get_allocator());
+                    bucket_alloc_traits::deallocate(ba, m_buckets, bucket_count());
+                }
+            }
+            m_buckets = nullptr;
+        }
+        m_num_buckets = 0;
+        m_max_bucket_capacity = 0;
+    }
+
+    // Moves the buckets out of other, whose m_num_buckets is then reset to 0. Inline buckets are copied but not cleared:
+    // allocate_buckets_from_shift() is always followed by overwriting them.
+    [[nodiscard]] static auto take_buckets(table& other) noexcept -> decltype(m_buckets) {
+        if constexpr (is_static) {
+            return other.m_buckets;
+        } else {
+            return std::exchange(other.m_buckets, nullptr);
+        }
+    }
+
+    void allocate_buckets_from_shift() {
+        m_num_buckets = calc_num_buckets(m_shifts);
+        if constexpr (!is_static) {
+            m_buckets = nullptr;
+            if constexpr (is_recyclable) {
+                // callers overwrite all buckets, so a recycled array doesn't need to be zeroed
+                if (auto* recycler = bucket_recycler::current(); nullptr != recycler) {
+                    m_buckets = static_cast<Bucket*>(recycler->take(sizeof(Bucket) * m_num_buckets));
+                }
+            }
+            if (nullptr == m_buckets) {
+                auto ba = bucket_alloc(m_values.get_allocator());
+                m_buckets = bucket_alloc_traits::allocate(ba, m_num_buckets);
+            }
+            ANKERL_UNORDERED_DENSE_COUNT(bytes_allocated, sizeof(Bucket) * m_num_buckets);
+        }
+        if (m_num_buckets == max_bucket_count()) {
+            // reached the maximum, make sure we can use each bucket (or each value of a static container)
+            m_max_bucket_capacity = max_size();
+        } else {
+            m_max_bucket_capacity = static_cast<value_idx_type>(static_cast<float>(m_num_buckets) * max_load_factor());
+        }
+    }
+
+    void clear_buckets() {
+        if (0 != m_num_buckets) {
+            std::memset(&at(m_buckets, 0), 0, sizeof(Bucket) * bucket_count());
+        }
+    }
+
+    void clear_and_fill_buckets_from_values() {
+        ANKERL_UNORDERED_DENSE_COUNT(rehashes, 1);
+        clear_buckets();
+        for (value_idx_type value_idx = 0, end_idx = static_cast<value_idx_type>(m_values.size()); value_idx < end_idx;
+             ++value_idx) {
+            auto const& key = get_key(m_values[value_idx]);
+            auto [dist_and_fingerprint, bucket] = next_while_less(key);
+
+            // we know for certain that key has not yet been inserted, so no need to check it.
+            place_and_shift_up({dist_and_fingerprint, value_idx}, bucket, false);
+        }
+    }
+
+    [[nodiscard]] auto bucket_bytes() const noexcept -> size_t {
+        if constexpr (is_static) {
+            return sizeof(static_buckets);
+        } else {
+            return m_num_buckets * sizeof(Bucket);
+        }
+    }
+
+    [[nodiscard]] auto values_capacity_bytes() const noexcept -> size_t {
+        if constexpr (has_capacity<value_container_type>) {
+            return m_values.capacity() * sizeof(value_type);
+        } else {
+            return m_values.size() * sizeof(value_type);
+        }
+    }
+
+    // Calls do_rehash, which reallocates the buckets, and reports it to the Observer.
+    template <typename Op>
+    void observe_rehash(Op do_rehash) {
+        if constexpr (is_observed) {
+            auto const old_bucket_count = bucket_count();
+            auto const start = std::chrono::steady_clock::now();
+            do_rehash();
+            Observer::on_rehash({old_bucket_count, bucket_count(), size(), std::chrono::steady_clock::now() - start});
+        } else {
+            do_rehash();
+        }
+    }
+
+    // Calls do_grow, which might increase the capacity of m_values, and counts and reports it to the Observer.
+    template <typename Op>
+    auto observe_values_growth(Op do_grow) -> decltype(do_grow()) {
+        if constexpr ((is_observed || is_counted) && has_capacity<value_container_type>) {
+            auto const old_capacity = m_values.capacity();
+            auto const start = is_observed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            if constexpr (std::is_void_v<decltype(do_grow())>) {
+                do_grow();
+                on_values_growth(old_capacity, start);
+            } else {
+                decltype(auto) result = do_grow();
+                on_values_growth(old_capacity, start);
+                return result;
+            }
+        } else {
+            return do_grow();
+        }
+    }
+
+    void on_values_growth(size_t old_capacity, [[maybe_unused]] std::chrono::steady_clock::time_point start) {
+        if (m_values.capacity() != old_capacity) {
+            count_values_allocation();
+            if constexpr (is_observed) {
+                Observer::on_values_growth(
+                    {old_capacity, m_values.capacity(), m_values.size(), std::chrono::steady_clock::now() - start});
+            }
+        }
+    }
+
+    // Counts the array of m_values after it was allocated again, it has room for capacity() values
+    void count_values_allocation() {
+        if constexpr (has_capacity<value_container_type>) {
+            ANKERL_UNORDERED_DENSE_COUNT(bytes_allocated, values_capacity_bytes());
+        }
+    }
+
+    template <typename... Args>
+    auto values_emplace_back(Args&&... args) -> value_type& {
+        auto emplace = [&]() -> value_type& {
+            return m_values.emplace_back(std::forward<Args>(args)...);
+        };
+        if constexpr ((is_observed || is_counted) && has_capacity<value_container_type>) {
+            // only an emplace into a full container grows it, all others skip the clock and the counters
+            if (ANKERL_UNORDERED_DENSE_UNLIKELY(m_values.size() == m_values.capacity())) {
+                return observe_values_growth(emplace);
+            }
+        }
+        return emplace();
+    }
+
+    void increase_size() {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(m_num_buckets == max_bucket_count())) {
+            if constexpr (is_static) {
+                // can't grow any further. Adding a new value throws when the static container is full.
+                return;
+            } else {
+                throw std::overflow_error("ankerl::unordered_dense: reached max bucket size, cannot increase size");
+            }
+        }
+        if (m_shifts > min_shifts) {
+            // a small static table without buckets can already be at its final size
+            --m_shifts;
+        }
+        observe_rehash([this] {
+            deallocate_buckets();
+            if constexpr (is_arena_allocated && has_reserve<value_container_type>) {
+                // The arena only reuses its most recent allocation. Growing the values to what the new buckets can hold
+                // right after freeing the old buckets puts them where the buckets were, and the buckets allocated last
+                // stay the arena's most recent allocation until the next rehash.
+                observe_values_growth([this] {
+                    m_values.reserve(std::min(
+                        static_cast<size_t>(static_cast<float>(calc_num_buckets(m_shifts)) * max_load_factor()), max_size()));
+                });
+            }
+            allocate_buckets_from_shift();
+            clear_and_fill_buckets_from_values();
+        });
+    }
+
+    // Replaces the value at value_idx with the last one, and removes the last value.
+    void replace_with_back(value_idx_type value_idx) {
+        if constexpr (has_replace_with_back<value_container_type>) {
+            // the container knows best, e.g. relocating_vector can use memcpy
+            m_values.replace_with_back(value_idx);
+        } else {
+            if (value_idx != m_values.size() - 1) {
+                m_values[value_idx] = std::move(m_values.back());
+            }
+            m_values.pop_back();
+        }
+    }
+
+    void do_erase(value_idx_type bucket_idx) {
+        auto const value_idx_to_remove = at(m_buckets, bucket_idx).m_value_idx;
+
+        // shift down until either empty or an element with correct spot is found
+        auto next_bucket_idx = next(bucket_idx);
+        while (at(m_buckets, next_bucket_idx).m_dist_and_fingerprint >= Bucket::dist_inc * 2) {
+            ANKERL_UNORDERED_DENSE_COUNT(erase_shifts, 1);
+            at(m_buckets, bucket_idx) = {dist_dec(at(m_buckets, next_bucket_idx).m_dist_and_fingerprint),
+                                         at(m_buckets, next_bucket_idx).m_value_idx};
+            bucket_idx = std::exchange(next_bucket_idx, next(next_bucket_idx));
+        }
+        at(m_buckets, bucket_idx) = {};
+
+        // update m_values
+        if (value_idx_to_remove != m_values.size() - 1) {
+            // no luck, we'll have to replace the value with the last one and update the index accordingly
+            auto const values_idx_back = static_cast<value_idx_type>(m_values.size() - 1);
+            replace_with_back(value_idx_to_remove);
+
+            // update the values_idx of the moved entry. No need to play the info game, just look until we find the values_idx
+            auto mh = mixed_hash(get_key(m_values[value_idx_to_remove]));
+            bucket_idx = bucket_idx_from_hash(mh);
+
+            while (values_idx_back != at(m_buckets, bucket_idx).m_value_idx) {
+                bucket_idx = next(bucket_idx);
+            }
+            at(m_buckets, bucket_idx).m_value_idx = value_idx_to_remove;
+        } else {
+            m_values.pop_back();
+        }
+    }
+
+    template <typename K>
+    auto do_erase_key(K&& key) -> size_t {
+        if (empty()) {
+            return 0;
+        }
+
+        auto [dist_and_fingerprint, bucket_idx] = next_while_less(key);
+
+        while (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
+               !key_equals(key, get_key(m_values[at(m_buckets, bucket_idx).m_value_idx]))) {
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+        }
+
+        if (dist_and_fingerprint != at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
+            return 0;
+        }
+        do_erase(bucket_idx);
+        return 1;
+    }
+
+    template <class K, class M>
+    auto do_insert_or_assign(K&& key, M&& mapped) -> std::pair<iterator, bool> {
+        auto it_isinserted = try_emplace(std::forward<K>(key), std::forward<M>(mapped));
+        if (!it_isinserted.second) {
+            it_isinserted.first->second = std::forward<M>(mapped);
+        }
+        return it_isinserted;
+    }
+
+    template <typename K, typename... Args>
+    auto do_place_element(dist_and_fingerprint_type dist_and_fingerprint, value_idx_type bucket_idx, K&& key, Args&&... args)
+        -> std::pair<iterator, bool> {
+
+        // emplace the new value. If that throws an exception, no harm done; index is still in a valid state
+        values_emplace_back(std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+
+        // place element and shift up until we find an empty spot
+        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
+        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
+        return {begin() + static_cast<difference_type>(value_idx), true};
+    }
+
+    template <typename K, typename... Args>
+    auto do_try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(is_full())) {
+            increase_size();
+        }
+
+        auto hash = mixed_hash(key);
+        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
+        auto bucket_idx = bucket_idx_from_hash(hash);
+
+        while (true) {
+            auto* bucket = &at(m_buckets, bucket_idx);
+            if (dist_and_fingerprint == bucket->m_dist_and_fingerprint) {
+                if (key_equals(key, m_values[bucket->m_value_idx].first)) {
+                    return {begin() + static_cast<difference_type>(bucket->m_value_idx), false};
+                }
+            } else if (dist_and_fingerprint > bucket->m_dist_and_fingerprint) {
+                return do_place_element(dist_and_fingerprint, bucket_idx, std::forward<K>(key), std::forward<Args>(args)...);
+            }
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+        }
+    }
+
+    template <typename K>
+    auto do_find(K const& key) -> iterator {
+        auto counts = detail::find_counts();
+        auto it = do_find(key, counts);
+#    if ANKERL_UNORDERED_DENSE_STATS
+        m_counters.add_find(counts, it != end());
+#    endif
+        return it;
+    }
+
+    template <typename K>
+    auto do_find(K const& key, detail::find_counts& counts) -> iterator {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(empty())) {
+            return end();
+        }
+
+        auto mh = mixed_hash(key);
+        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(mh);
+        auto bucket_idx = bucket_idx_from_hash(mh);
+        auto* bucket = &at(m_buckets, bucket_idx);
+
+        // unrolled loop. *Always* check a few directly, then enter the loop. This is faster.
+        counts.add_probe_step();
+        if (dist_and_fingerprint == bucket->m_dist_and_fingerprint &&
+            counts.key_equals(m_equal, key, get_key(m_values[bucket->m_value_idx]))) {
+            return begin() + static_cast<difference_type>(bucket->m_value_idx);
+        }
+        dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+        bucket_idx = next(bucket_idx);
+        bucket = &at(m_buckets, bucket_idx);
+
+        counts.add_probe_step();
+        if (dist_and_fingerprint == bucket->m_dist_and_fingerprint &&
+            counts.key_equals(m_equal, key, get_key(m_values[bucket->m_value_idx]))) {
+            return begin() + static_cast<difference_type>(bucket->m_value_idx);
+        }
+        dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+        bucket_idx = next(bucket_idx);
+        bucket = &at(m_buckets, bucket_idx);
+
+        while (true) {
+            counts.add_probe_step();
+            if (dist_and_fingerprint == bucket->m_dist_and_fingerprint) {
+                if (counts.key_equals(m_equal, key, get_key(m_values[bucket->m_value_idx]))) {
+                    return begin() + static_cast<difference_type>(bucket->m_value_idx);
+                }
+            } else if (dist_and_fingerprint > bucket->m_dist_and_fingerprint) {
+                return end();
+            }
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+            bucket = &at(m_buckets, bucket_idx);
+        }
+    }
+
+    template <typename K>
+    auto do_find(K const& key) const -> const_iterator {
+        return const_cast<table*>(this)->do_find(key); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+
+    template <typename K, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto do_at(K const& key) -> Q& {
+        if (auto it = find(key); end() != it) {
+            return it->second;
+        }
+        throw std::out_of_range("ankerl::unordered_dense::map::at(): key not found");
+    }
+
+    template <typename K, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto do_at(K const& key) const -> Q const& {
+        return const_cast<table*>(this)->at(key); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+
+public:
+    table()
+        : table(0) {}
+
+    explicit table(size_t bucket_count,
+                   Hash const& hash = Hash(),
+                   KeyEqual const& equal = KeyEqual(),
+                   allocator_type const& alloc_or_container = allocator_type())
+        : m_values(alloc_or_container)
+        , m_hash(hash)
+        , m_equal(equal) {
+        if (0 != bucket_count) {
+            reserve(bucket_count);
+        }
+    }
+
+    table(size_t bucket_count, allocator_type const& alloc)
+        : table(bucket_count, Hash(), KeyEqual(), alloc) {}
+
+    table(size_t bucket_count, Hash const& hash, allocator_type const& alloc)
+        : table(bucket_count, hash, KeyEqual(), alloc) {}
+
+    explicit table(allocator_type const& alloc)
+        : table(0, Hash(), KeyEqual(), alloc) {}
+
+    template <class InputIt>
+    table(InputIt first,
+          InputIt last,
+          size_type bucket_count = 0,
+          Hash const& hash = Hash(),
+          KeyEqual const& equal = KeyEqual(),
+          allocator_type const& alloc = allocator_type())
+        : table(bucket_count, hash, equal, alloc) {
+        insert(first, last);
+    }
+
+    template <class InputIt>
+    table(InputIt first, InputIt last, size_type bucket_count, allocator_type const& alloc)
+        : table(first, last, bucket_count, Hash(), KeyEqual(), alloc) {}
+
+    template <class InputIt>
+    table(InputIt first, InputIt last, size_type bucket_count, Hash const& hash, allocator_type const& alloc)
+        : table(first, last, bucket_count, hash, KeyEqual(), alloc) {}
+
+    table(table const& other)
+        : table(other, other.m_values.get_allocator()) {}
+
+    table(table const& other, allocator_type const& alloc)
+        : m_values(other.m_values, alloc)
+        , m_max_load_factor(other.m_max_load_factor)
+        , m_hash(other.m_hash)
+        , m_equal(other.m_equal) {
+        count_values_allocation();
+        copy_buckets(other);
+    }
+
+    // a static container moves its values one by one, which can throw
+    table(table&& other) noexcept(std::is_nothrow_move_constructible_v<value_container_type>)
+        : table(std::move(other), other.m_values.get_allocator()) {}
+
+    table(table&& other, allocator_type const& alloc) noexcept(std::is_nothrow_move_constructible_v<value_container_type>)
+        : m_values(std::move(other.m_values), alloc)
+        , m_buckets(take_buckets(other))
+        , m_num_buckets(std::exchange(other.m_num_buckets, 0))
+        , m_max_bucket_capacity(std::exchange(other.m_max_bucket_capacity, 0))
+        , m_max_load_factor(std::exchange(other.m_max_load_factor, default_max_load_factor))
+        , m_hash(std::exchange(other.m_hash, {}))
+        , m_equal(std::exchange(other.m_equal, {}))
+        , m_shifts(std::exchange(other.m_shifts, initial_shifts)) {
+        other.m_values.clear();
+    }
+
+    table(std::initializer_list<value_type> ilist,
+          size_t bucket_count = 0,
+          Hash const& hash = Hash(),
+          KeyEqual const& equal = KeyEqual(),
+          allocator_type const& alloc = allocator_type())
+        : table(bucket_count, hash, equal, alloc) {
+        insert(ilist);
+    }
+
+    table(std::initializer_list<value_type> ilist, size_type bucket_count, allocator_type const& alloc)
+        : table(ilist, bucket_count, Hash(), KeyEqual(), alloc) {}
+
+    table(std::initializer_list<value_type> init, size_type bucket_count, Hash const& hash, allocator_type const& alloc)
+        : table(init, bucket_count, hash, KeyEqual(), alloc) {}
+
+    ~table() {
+        deallocate_buckets();
+    }
+
+    auto operator=(table const& other) -> table& {
+        if (&other != this) {
+            observe_rehash([&] {
+                deallocate_buckets(); // deallocate before m_values is set (might have another allocator)
+#    if ANKERL_UNORDERED_DENSE_STATS
+                m_counters.reset(); // before the copy, its allocations are counted
+#    endif
+                observe_values_growth([&] {
+                    m_values = other.m_values;
+                });
+                m_max_load_factor = other.m_max_load_factor;
+                m_hash = other.m_hash;
+                m_equal = other.m_equal;
+                m_shifts = initial_shifts;
+                copy_buckets(other);
+            });
+        }
+        return *this;
+    }
+
+    auto operator=(table&& other) noexcept(
+        noexcept(std::is_nothrow_move_assignable_v<value_container_type>&& std::is_nothrow_move_assignable_v<Hash>&&
+                     std::is_nothrow_move_assignable_v<KeyEqual>)) -> table& {
+        if (&other != this) {
+            deallocate_buckets(); // deallocate before m_values is set (might have another allocator)
+            m_values = std::move(other.m_values);
+            m_buckets = take_buckets(other);
+            m_num_buckets = std::exchange(other.m_num_buckets, 0);
+            m_max_bucket_capacity = std::exchange(other.m_max_bucket_capacity, 0);
+            m_max_load_factor = std::exchange(other.m_max_load_factor, default_max_load_factor);
+            m_hash = std::exchange(other.m_hash, {});
+            m_equal = std::exchange(other.m_equal, {});
+            m_shifts = std::exchange(other.m_shifts, initial_shifts);
+            other.m_values.clear();
+#    if ANKERL_UNORDERED_DENSE_STATS
+            m_counters.reset();
+#    endif
+        }
+        return *this;
+    }
+
+    auto operator=(std::initializer_list<value_type> ilist) -> table& {
+        clear();
+        insert(ilist);
+        return *this;
+    }
+
+    auto get_allocator() const noexcept -> allocator_type {
+        return m_values.get_allocator();
+    }
+
+    // iterators //////////////////////////////////////////////////////////////
+
+    auto begin() noexcept -> iterator {
+        return m_values.begin();
+    }
+
+    auto begin() const noexcept -> const_iterator {
+        return m_values.begin();
+    }
+
+    auto cbegin() const noexcept -> const_iterator {
+        return m_values.cbegin();
+    }
+
+    auto end() noexcept -> iterator {
+        return m_values.end();
+    }
+
+    auto cend() const noexcept -> const_iterator {
+        return m_values.cend();
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return m_values.end();
+    }
+
+    // capacity ///////////////////////////////////////////////////////////////
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_values.empty();
+    }
+
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return m_values.size();
+    }
+
+    [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+        if constexpr (is_static) {
+            return value_container_type::static_capacity;
+        } else if constexpr (std::numeric_limits<value_idx_type>::max() == std::numeric_limits<size_t>::max()) {
+            return size_t{1} << (sizeof(value_idx_type) * 8 - 1);
+        } else {
+            return size_t{1} << (sizeof(value_idx_type) * 8);
+        }
+    }
+
+    // modifiers //////////////////////////////////////////////////////////////
+
+    void clear() {
+        m_values.clear();
+        clear_buckets();
+    }
+
+    auto insert(value_type const& value) -> std::pair<iterator, bool> {
+        return emplace(value);
+    }
+
+    auto insert(value_type&& value) -> std::pair<iterator, bool> {
+        return emplace(std::move(value));
+    }
+
+    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, bool> = true>
+    auto insert(P&& value) -> std::pair<iterator, bool> {
+        return emplace(std::forward<P>(value));
+    }
+
+    auto insert(const_iterator /*hint*/, value_type const& value) -> iterator {
+        return insert(value).first;
+    }
+
+    auto insert(const_iterator /*hint*/, value_type&& value) -> iterator {
+        return insert(std::move(value)).first;
+    }
+
+    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, bool> = true>
+    auto insert(const_iterator /*hint*/, P&& value) -> iterator {
+        return insert(std::forward<P>(value)).first;
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        while (first != last) {
+            insert(*first);
+            ++first;
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    // nonstandard API: *this is emptied.
+    // Also see "A Standard flat_map" https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2022/p0429r9.pdf
+    auto extract() && -> value_container_type {
+        return std::move(m_values);
+    }
+
+    // nonstandard API:
+    // Discards the internally held container and replaces it with the one passed. Erases non-unique elements.
+    auto replace(value_container_type&& container) {
+        if (container.size() > max_size()) {
+            throw std::out_of_range("ankerl::unordered_dense::map::replace(): too many elements");
+        }
+
+        auto fill_buckets = [&] {
+            clear_buckets();
+
+            m_values = std::move(container);
+
+            // can't use clear_and_fill_buckets_from_values() because container elements might not be unique
+            auto value_idx = value_idx_type{};
+
+            // loop until we reach the end of the container. duplicated entries will be replaced with back().
+            while (value_idx != static_cast<value_idx_type>(m_values.size())) {
+                auto const& key = get_key(m_values[value_idx]);
+
+                auto hash = mixed_hash(key);
+                auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
+                auto bucket_idx = bucket_idx_from_hash(hash);
+
+                bool key_found = false;
+                while (true) {
+                    auto const& bucket = at(m_buckets, bucket_idx);
+                    if (dist_and_fingerprint > bucket.m_dist_and_fingerprint) {
+                        break;
+                    }
+                    if (dist_and_fingerprint == bucket.m_dist_and_fingerprint &&
+                        key_equals(key, m_values[bucket.m_value_idx].first)) {
+                        key_found = true;
+                        break;
+                    }
+                    dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+                    bucket_idx = next(bucket_idx);
+                }
+
+                if (key_found) {
+                    replace_with_back(value_idx);
+                } else {
+                    place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
+                    ++value_idx;
+                }
+            }
+        };
+
+        auto shifts = calc_shifts_for_size(container.size());
+        if (0 == m_num_buckets || shifts < m_shifts || container.get_allocator() != m_values.get_allocator()) {
+            m_shifts = shifts;
+            observe_rehash([&] {
+                deallocate_buckets();
+                allocate_buckets_from_shift();
+                fill_buckets();
+            });
+        } else {
+            fill_buckets();
+        }
+    }
+
+    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto insert_or_assign(Key const& key, M&& mapped) -> std::pair<iterator, bool> {
+        return do_insert_or_assign(key, std::forward<M>(mapped));
+    }
+
+    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto insert_or_assign(Key&& key, M&& mapped) -> std::pair<iterator, bool> {
+        return do_insert_or_assign(std::move(key), std::forward<M>(mapped));
+    }
+
+    template <typename K,
+              typename M,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto insert_or_assign(K&& key, M&& mapped) -> std::pair<iterator, bool> {
+        return do_insert_or_assign(std::forward<K>(key), std::forward<M>(mapped));
+    }
+
+    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto insert_or_assign(const_iterator /*hint*/, Key const& key, M&& mapped) -> iterator {
+        return do_insert_or_assign(key, std::forward<M>(mapped)).first;
+    }
+
+    template <class M, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
     auto insert_or_assign(const_iterator /*hint*/, Key&& key, M&& mapped) -> iterator {
         return do_insert_or_assign(std::move(key), std::forward<M>(mapped)).first;
     }
 
-    template <typename K,
-              typename M,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto insert_or_assign(const_iterator /*hint*/, K&& key, M&& mapped) -> iterator {
-        return do_insert_or_assign(std::forward<K>(key), std::forward<M>(mapped)).first;
+    template <typename K,
+              typename M,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto insert_or_assign(const_iterator /*hint*/, K&& key, M&& mapped) -> iterator {
+        return do_insert_or_assign(std::forward<K>(key), std::forward<M>(mapped)).first;
+    }
+
+    // Single arguments for unordered_set can be used without having to construct the value_type
+    template <class K,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<!is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto emplace(K&& key) -> std::pair<iterator, bool> {
+        if (is_full()) {
+            increase_size();
+        }
+
+        auto hash = mixed_hash(key);
+        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
+        auto bucket_idx = bucket_idx_from_hash(hash);
+
+        while (dist_and_fingerprint <= at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
+            if (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
+                key_equals(key, m_values[at(m_buckets, bucket_idx).m_value_idx])) {
+                // found it, return without ever actually creating anything
+                return {begin() + static_cast<difference_type>(at(m_buckets, bucket_idx).m_value_idx), false};
+            }
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+        }
+
+        // value is new, insert element first, so when exception happens we are in a valid state
+        values_emplace_back(std::forward<K>(key));
+        // now place the bucket and shift up until we find an empty spot
+        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
+        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
+        return {begin() + static_cast<difference_type>(value_idx), true};
+    }
+
+    template <class... Args>
+    auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+        if (is_full()) {
+            increase_size();
+        }
+
+        if constexpr (is_static) {
+            if (ANKERL_UNORDERED_DENSE_UNLIKELY(size() == max_size())) {
+                // no space to instantiate the value_type in the container, but the key might already be there
+                auto val = value_type(std::forward<Args>(args)...);
+                if (auto it = find(get_key(val)); it != end()) {
+                    return {it, false};
+                }
+                throw std::overflow_error("ankerl::unordered_dense: static container is full");
+            }
+        }
+
+        // we have to instantiate the value_type to be able to access the key.
+        // 1. emplace_back the object so it is constructed. 2. If the key is already there, pop it later in the loop.
+        auto& key = get_key(values_emplace_back(std::forward<Args>(args)...));
+        auto hash = mixed_hash(key);
+        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
+        auto bucket_idx = bucket_idx_from_hash(hash);
+
+        while (dist_and_fingerprint <= at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
+            if (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
+                key_equals(key, get_key(m_values[at(m_buckets, bucket_idx).m_value_idx]))) {
+                m_values.pop_back(); // value was already there, so get rid of it
+                return {begin() + static_cast<difference_type>(at(m_buckets, bucket_idx).m_value_idx), false};
+            }
+            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+            bucket_idx = next(bucket_idx);
+        }
+
+        // value is new, place the bucket and shift up until we find an empty spot
+        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
+        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
+
+        return {begin() + static_cast<difference_type>(value_idx), true};
+    }
+
+    template <class... Args>
+    auto emplace_hint(const_iterator /*hint*/, Args&&... args) -> iterator {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto try_emplace(Key const& key, Args&&... args) -> std::pair<iterator, bool> {
+        return do_try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto try_emplace(Key&& key, Args&&... args) -> std::pair<iterator, bool> {
+        return do_try_emplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto try_emplace(const_iterator /*hint*/, Key const& key, Args&&... args) -> iterator {
+        return do_try_emplace(key, std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto try_emplace(const_iterator /*hint*/, Key&& key, Args&&... args) -> iterator {
+        return do_try_emplace(std::move(key), std::forward<Args>(args)...).first;
+    }
+
+    template <
+        typename K,
+        typename... Args,
+        typename Q = T,
+        typename H = Hash,
+        typename KE = KeyEqual,
+        std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE> && is_neither_convertible_v<K&&, iterator, const_iterator>,
+                         bool> = true>
+    auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
+        return do_try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    template <
+        typename K,
+        typename... Args,
+        typename Q = T,
+        typename H = Hash,
+        typename KE = KeyEqual,
+        std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE> && is_neither_convertible_v<K&&, iterator, const_iterator>,
+                         bool> = true>
+    auto try_emplace(const_iterator /*hint*/, K&& key, Args&&... args) -> iterator {
+        return do_try_emplace(std::forward<K>(key), std::forward<Args>(args)...).first;
+    }
+
+    auto erase(iterator it) -> iterator {
+        auto hash = mixed_hash(get_key(*it));
+        auto bucket_idx = bucket_idx_from_hash(hash);
+
+        auto const value_idx_to_remove = static_cast<value_idx_type>(it - cbegin());
+        while (at(m_buckets, bucket_idx).m_value_idx != value_idx_to_remove) {
+            bucket_idx = next(bucket_idx);
+        }
+
+        do_erase(bucket_idx);
+        return begin() + static_cast<difference_type>(value_idx_to_remove);
+    }
+
+    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto erase(const_iterator it) -> iterator {
+        return erase(begin() + (it - cbegin()));
+    }
+
+    auto erase(const_iterator first, const_iterator last) -> iterator {
+        auto const idx_first = first - cbegin();
+        auto const idx_last = last - cbegin();
+        auto const first_to_last = std::distance(first, last);
+        auto const last_to_end = std::distance(last, cend());
+
+        // remove elements from left to right which moves elements from the end back
+        auto const mid = idx_first + std::min(first_to_last, last_to_end);
+        auto idx = idx_first;
+        while (idx != mid) {
+            erase(begin() + idx);
+            ++idx;
+        }
+
+        // all elements from the right are moved, now remove the last element until all done
+        idx = idx_last;
+        while (idx != mid) {
+            --idx;
+            erase(begin() + idx);
+        }
+
+        return begin() + idx_first;
+    }
+
+    auto erase(Key const& key) -> size_t {
+        return do_erase_key(key);
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto erase(K&& key) -> size_t {
+        return do_erase_key(std::forward<K>(key));
+    }
+
+    void swap(table& other) noexcept(noexcept(std::is_nothrow_swappable_v<value_container_type>&&
+                                                  std::is_nothrow_swappable_v<Hash>&& std::is_nothrow_swappable_v<KeyEqual>)) {
+        using std::swap;
+        swap(other, *this);
+    }
+
+    // lookup /////////////////////////////////////////////////////////////////
+
+    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto at(key_type const& key) -> Q& {
+        return do_at(key);
+    }
+
+    template <typename K,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto at(K const& key) -> Q& {
+        return do_at(key);
+    }
+
+    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto at(key_type const& key) const -> Q const& {
+        return do_at(key);
+    }
+
+    template <typename K,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto at(K const& key) const -> Q const& {
+        return do_at(key);
+    }
+
+    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto operator[](Key const& key) -> Q& {
+        return try_emplace(key).first->second;
+    }
+
+    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
+    auto operator[](Key&& key) -> Q& {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    template <typename K,
+              typename Q = T,
+              typename H = Hash,
+              typename KE = KeyEqual,
+              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
+    auto operator[](K&& key) -> Q& {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    auto count(Key const& key) const -> size_t {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto count(K const& key) const -> size_t {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    auto find(Key const& key) -> iterator {
+        return do_find(key);
+    }
+
+    auto find(Key const& key) const -> const_iterator {
+        return do_find(key);
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto find(K const& key) -> iterator {
+        return do_find(key);
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto find(K const& key) const -> const_iterator {
+        return do_find(key);
+    }
+
+    auto contains(Key const& key) const -> bool {
+        return find(key) != end();
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto contains(K const& key) const -> bool {
+        return find(key) != end();
+    }
+
+    auto equal_range(Key const& key) -> std::pair<iterator, iterator> {
+        auto it = do_find(key);
+        return {it, it == end() ? end() : it + 1};
+    }
+
+    auto equal_range(const Key& key) const -> std::pair<const_iterator, const_iterator> {
+        auto it = do_find(key);
+        return {it, it == end() ? end() : it + 1};
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto equal_range(K const& key) -> std::pair<iterator, iterator> {
+        auto it = do_find(key);
+        return {it, it == end() ? end() : it + 1};
+    }
+
+    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
+    auto equal_range(K const& key) const -> std::pair<const_iterator, const_iterator> {
+        auto it = do_find(key);
+        return {it, it == end() ? end() : it + 1};
+    }
+
+    // bucket interface ///////////////////////////////////////////////////////
+
+    auto bucket_count() const noexcept -> size_t { // NOLINT(modernize-use-nodiscard)
+        return m_num_buckets;
+    }
+
+    static constexpr auto max_bucket_count() noexcept -> size_t { // NOLINT(modernize-use-nodiscard)
+        if constexpr (is_static) {
+            return std::tuple_size_v<static_buckets>;
+        } else {
+            return max_size();
+        }
     }
 
-    // Single arguments for unordered_set can be used without having to construct the value_type
-    template <class K,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<!is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto emplace(K&& key) -> std::pair<iterator, bool> {
-        if (is_full()) {
-            increase_size();
+    // hash policy ////////////////////////////////////////////////////////////
+
+    [[nodiscard]] auto load_factor() const -> float {
+        return bucket_count() ? static_cast<float>(size()) / static_cast<float>(bucket_count()) : 0.0F;
+    }
+
+    [[nodiscard]] auto max_load_factor() const -> float {
+        return m_max_load_factor;
+    }
+
+    void max_load_factor(float ml) {
+        m_max_load_factor = ml;
+        if (m_num_buckets != max_bucket_count()) {
+            m_max_bucket_capacity = static_cast<value_idx_type>(static_cast<float>(bucket_count()) * max_load_factor());
         }
+    }
 
-        auto hash = mixed_hash(key);
-        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
-        auto bucket_idx = bucket_idx_from_hash(hash);
+    void rehash(size_t count) {
+        count = std::min(count, max_size());
+        auto shifts = calc_shifts_for_size(std::max(count, size()));
+        if (shifts != m_shifts) {
+            m_shifts = shifts;
+            observe_rehash([this] {
+                deallocate_buckets();
+                if constexpr (has_capacity<value_container_type>) {
+                    auto const old_capacity = m_values.capacity();
+                    m_values.shrink_to_fit();
+                    if (m_values.capacity() != old_capacity) {
+                        count_values_allocation();
+                    }
+                } else {
+                    m_values.shrink_to_fit();
+                }
+                allocate_buckets_from_shift();
+                clear_and_fill_buckets_from_values();
+            });
+        }
+    }
 
-        while (dist_and_fingerprint <= at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
-            if (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
-                m_equal(key, m_values[at(m_buckets, bucket_idx).m_value_idx])) {
-                // found it, return without ever actually creating anything
-                return {begin() + static_cast<difference_type>(at(m_buckets, bucket_idx).m_value_idx), false};
+    void reserve(size_t capa) {
+        capa = std::min(capa, max_size());
+        if constexpr (has_reserve<value_container_type>) {
+            // std::deque doesn't have reserve(). Make sure we only call when available
+            observe_values_growth([&] {
+                m_values.reserve(capa);
+            });
+        }
+        auto shifts = calc_shifts_for_size(std::max(capa, size()));
+        if (0 == m_num_buckets || shifts < m_shifts) {
+            m_shifts = shifts;
+            observe_rehash([this] {
+                deallocate_buckets();
+                allocate_buckets_from_shift();
+                clear_and_fill_buckets_from_values();
+            });
+        }
+    }
+
+    // observers //////////////////////////////////////////////////////////////
+
+    auto hash_function() const -> hasher {
+        return m_hash;
+    }
+
+    auto key_eq() const -> key_equal {
+        return m_equal;
+    }
+
+    // nonstandard API: expose the underlying values container
+    [[nodiscard]] auto values() const noexcept -> value_container_type const& {
+        return m_values;
+    }
+
+    // nonstandard API: distances, probe lengths and memory, see table_stats. Goes through all buckets, so it is
+    // O(bucket_count()); nothing is tracked while the map is used.
+    [[nodiscard]] auto stats() const -> table_stats {
+        auto st = table_stats();
+        st.num_elements = size();
+        st.num_buckets = bucket_count();
+        st.bucket_bytes = bucket_bytes();
+        st.value_bytes = values_capacity_bytes();
+
+        size_t sum_probe_lengths = 0;
+        for (size_t idx = 0; idx < m_num_buckets; ++idx) {
+            auto const dist_and_fingerprint = static_cast<uint64_t>(at(m_buckets, idx).m_dist_and_fingerprint);
+            if (0 == dist_and_fingerprint) {
+                continue;
+            }
+            auto const dist = static_cast<size_t>(dist_and_fingerprint / Bucket::dist_inc) - 1;
+            if (st.distance_histogram.size() <= dist) {
+                st.distance_histogram.resize(dist + 1);
+            }
+            ++st.distance_histogram[dist];
+            sum_probe_lengths += dist + 1;
+
+            // a lookup of this element compares keys in all buckets before it that have the same dist_and_fingerprint
+            auto const fingerprint = dist_and_fingerprint & Bucket::fingerprint_mask;
+            auto probe_idx = (idx + m_num_buckets - dist) % m_num_buckets;
+            for (uint64_t d = 1; d <= dist; ++d) {
+                auto const other = static_cast<uint64_t>(at(m_buckets, probe_idx).m_dist_and_fingerprint);
+                if (other == ((d * Bucket::dist_inc) | fingerprint)) {
+                    ++st.fingerprint_collisions;
+                }
+                probe_idx = next(static_cast<value_idx_type>(probe_idx));
             }
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
         }
 
-        // value is new, insert element first, so when exception happens we are in a valid state
-        m_values.emplace_back(std::forward<K>(key));
-        // now place the bucket and shift up until we find an empty spot
-        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
-        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
-        return {begin() + static_cast<difference_type>(value_idx), true};
+        st.max_probe_length = st.distance_histogram.size();
+        if (0 != st.num_elements) {
+            st.mean_probe_length = static_cast<double>(sum_probe_lengths) / static_cast<double>(st.num_elements);
+        }
+        if (0 != st.num_buckets) {
+            st.occupancy = static_cast<double>(st.num_elements) / static_cast<double>(st.num_buckets);
+        }
+        if (sum_probe_lengths != st.num_elements) {
+            st.fingerprint_collision_rate =
+                static_cast<double>(st.fingerprint_collisions) / static_cast<double>(sum_probe_lengths - st.num_elements);
+        }
+        return st;
     }
 
-    template <class... Args>
-    auto emplace(Args&&... args) -> std::pair<iterator, bool> {
-        if (is_full()) {
-            increase_size();
+    // nonstandard API: bytes of buckets and values, see table_memory. This is O(1) unless key or mapped type have a
+    // heap_size specialization, then each element is asked how much memory it owns.
+    [[nodiscard]] auto memory_usage() const noexcept -> table_memory {
+        auto mem = table_memory();
+        mem.bucket_bytes = bucket_bytes();
+        mem.values_capacity_bytes = values_capacity_bytes();
+        mem.values_bytes = m_values.size() * sizeof(value_type);
+        if constexpr (is_map_v<T>) {
+            if constexpr (has_heap_size<Key> || has_heap_size<T>) {
+                for (auto const& kv : m_values) {
+                    mem.heap_bytes += heap_size_of(kv.first) + heap_size_of(kv.second);
+                }
+            }
+        } else if constexpr (has_heap_size<Key>) {
+            for (auto const& key : m_values) {
+                mem.heap_bytes += heap_size_of(key);
+            }
+        }
+        mem.total_bytes = mem.bucket_bytes + mem.values_capacity_bytes + mem.heap_bytes;
+        if (!empty()) {
+            mem.overhead_per_element = static_cast<double>(mem.bucket_bytes + mem.values_capacity_bytes - mem.values_bytes) /
+                                       static_cast<double>(size());
         }
+        return mem;
+    }
 
-        // we have to instantiate the value_type to be able to access the key.
-        // 1. emplace_back the object so it is constructed. 2. If the key is already there, pop it later in the loop.
-        auto& key = get_key(m_values.emplace_back(std::forward<Args>(args)...));
-        auto hash = mixed_hash(key);
-        auto dist_and_fingerprint = dist_and_fingerprint_from_hash(hash);
-        auto bucket_idx = bucket_idx_from_hash(hash);
+#    if ANKERL_UNORDERED_DENSE_STATS
+    // nonstandard API: snapshot of the operation counters, only with ANKERL_UNORDERED_DENSE_STATS. Copies and moved-to
+    // tables start at 0, also when they are assigned to. Safe to call while other threads use the const API.
+    [[nodiscard]] auto counters() const noexcept -> table_counters {
+        return m_counters.load();
+    }
 
-        while (dist_and_fingerprint <= at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
-            if (dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
-                m_equal(key, get_key(m_values[at(m_buckets, bucket_idx).m_value_idx]))) {
-                m_values.pop_back(); // value was already there, so get rid of it
-                return {begin() + static_cast<difference_type>(at(m_buckets, bucket_idx).m_value_idx), false};
+    void reset_counters() noexcept {
+        m_counters.reset();
+    }
+#    endif
+
+    // non-member functions ///////////////////////////////////////////////////
+
+    friend auto operator==(table const& a, table const& b) -> bool {
+        if (&a == &b) {
+            return true;
+        }
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (auto const& b_entry : b) {
+            auto it = a.find(get_key(b_entry));
+            if constexpr (is_map_v<T>) {
+                // map: check that key is here, then also check that value is the same
+                if (a.end() == it || !(b_entry.second == it->second)) {
+                    return false;
+                }
+            } else {
+                // set: only check that the key is here
+                if (a.end() == it) {
+                    return false;
+                }
             }
-            dist_and_fingerprint = dist_inc(dist_and_fingerprint);
-            bucket_idx = next(bucket_idx);
         }
+        return true;
+    }
 
-        // value is new, place the bucket and shift up until we find an empty spot
-        auto value_idx = static_cast<value_idx_type>(m_values.size() - 1);
-        place_and_shift_up({dist_and_fingerprint, value_idx}, bucket_idx);
+    friend auto operator!=(table const& a, table const& b) -> bool {
+        return !(a == b);
+    }
+};
 
-        return {begin() + static_cast<difference_type>(value_idx), true};
+} // namespace detail
+
+template <class Key,
+          class T,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class AllocatorOrContainer = std::allocator<std::pair<Key, T>>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using map = detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket, Observer>;
+
+template <class Key,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class AllocatorOrContainer = std::allocator<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using set = detail::table<Key, void, Hash, KeyEqual, AllocatorOrContainer, Bucket, Observer>;
+
+// Fixed capacity of N elements. Values and buckets are stored inline, so these never allocate.
+template <class Key,
+          class T,
+          size_t N,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using static_map = detail::table<Key, T, Hash, KeyEqual, detail::static_vector<std::pair<Key, T>, N>, Bucket, Observer>;
+
+template <class Key,
+          size_t N,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using static_set = detail::table<Key, void, Hash, KeyEqual, detail::static_vector<Key, N>, Bucket, Observer>;
+
+// All memory comes from an arena, construct with e.g. `arena_map<K, V> map(arena);`
+template <class Key,
+          class T,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using arena_map = detail::table<Key, T, Hash, KeyEqual, arena_allocator<std::pair<Key, T>>, Bucket, Observer>;
+
+template <class Key,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using arena_set = detail::table<Key, void, Hash, KeyEqual, arena_allocator<Key>, Bucket, Observer>;
+
+// interner ///////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Key of a table with string_view keys that copies its characters into an arena when the table constructs the stored key
+// from it. That happens only after the lookup found the key to be new, so finding and inserting hashes the key just once
+// and existing keys never touch the arena.
+class arena_key {
+    std::string_view m_str;
+    std::unique_ptr<arena>* m_chars; // created lazily by the first non-empty key
+    std::string_view m_stored{};
+
+public:
+    arena_key(std::string_view str, std::unique_ptr<arena>& chars) noexcept
+        : m_str(str)
+        , m_chars(&chars) {}
+
+    [[nodiscard]] auto str() const noexcept -> std::string_view {
+        return m_str;
     }
 
-    template <class... Args>
-    auto emplace_hint(const_iterator /*hint*/, Args&&... args) -> iterator {
-        return emplace(std::forward<Args>(args)...).first;
+    explicit operator std::string_view() {
+        if (!m_str.empty()) {
+            if (!*m_chars) {
+                *m_chars = std::make_unique<arena>();
+            }
+            auto* chars = static_cast<char*>((*m_chars)->allocate(m_str.size(), 1));
+            std::memcpy(chars, m_str.data(), m_str.size());
+            m_stored = std::string_view(chars, m_str.size());
+        }
+        return m_stored;
     }
 
-    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto try_emplace(Key const& key, Args&&... args) -> std::pair<iterator, bool> {
-        return do_try_emplace(key, std::forward<Args>(args)...);
+    // Gives the copied characters back to the arena, when constructing the rest of the table's value failed
+    void forget() noexcept {
+        if (!m_stored.empty()) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            (*m_chars)->deallocate(const_cast<char*>(m_stored.data()), m_stored.size());
+            m_stored = {};
+        }
     }
+};
 
-    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto try_emplace(Key&& key, Args&&... args) -> std::pair<iterator, bool> {
-        return do_try_emplace(std::move(key), std::forward<Args>(args)...);
+// Hash and KeyEqual for string_view keys that also accept an arena_key.
+template <typename Hash>
+struct arena_key_hash : Hash {
+    using is_transparent = void;
+
+    auto operator()(std::string_view str) const -> decltype(std::declval<Hash const&>()(str)) {
+        return Hash::operator()(str);
     }
 
-    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto try_emplace(const_iterator /*hint*/, Key const& key, Args&&... args) -> iterator {
-        return do_try_emplace(key, std::forward<Args>(args)...).first;
+    auto operator()(arena_key const& key) const -> decltype(std::declval<Hash const&>()(key.str())) {
+        return Hash::operator()(key.str());
     }
+};
 
-    template <class... Args, typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto try_emplace(const_iterator /*hint*/, Key&& key, Args&&... args) -> iterator {
-        return do_try_emplace(std::move(key), std::forward<Args>(args)...).first;
+template <typename KeyEqual>
+struct arena_key_equal : KeyEqual {
+    using is_transparent = void;
+
+    auto operator()(std::string_view a, std::string_view b) const -> bool {
+        return KeyEqual::operator()(a, b);
     }
 
-    template <
-        typename K,
-        typename... Args,
-        typename Q = T,
-        typename H = Hash,
-        typename KE = KeyEqual,
-        std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE> && is_neither_convertible_v<K&&, iterator, const_iterator>,
-                         bool> = true>
-    auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
-        return do_try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    auto operator()(arena_key const& a, std::string_view b) const -> bool {
+        return KeyEqual::operator()(a.str(), b);
     }
+};
 
-    template <
-        typename K,
-        typename... Args,
-        typename Q = T,
-        typename H = Hash,
-        typename KE = KeyEqual,
-        std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE> && is_neither_convertible_v<K&&, iterator, const_iterator>,
-                         bool> = true>
-    auto try_emplace(const_iterator /*hint*/, K&& key, Args&&... args) -> iterator {
-        return do_try_emplace(std::forward<K>(key), std::forward<Args>(args)...).first;
+// Finds key in a set or map that uses arena_key_hash and arena_key_equal, or adds it with the mapped value constructed from
+// args. The key is hashed once, and its characters are appended to chars only when it is new. When constructing the value
+// throws, the characters are given back.
+template <typename Table, typename... Args>
+auto arena_key_try_emplace(Table& table, std::unique_ptr<arena>& chars, std::string_view key, Args&&... args)
+    -> std::pair<typename Table::iterator, bool> {
+    auto k = arena_key(key, chars);
+    try {
+        if constexpr (std::is_same_v<typename Table::value_type, std::string_view>) {
+            static_assert(sizeof...(Args) == 0, "a set has no mapped value");
+            return table.emplace(k);
+        } else {
+            return table.try_emplace(k, std::forward<Args>(args)...);
+        }
+    } catch (...) {
+        k.forget();
+        throw;
+    }
+}
+
+} // namespace detail
+
+// Maps strings to dense uint32_t ids and back. The characters of all strings are stored contiguously in an arena, the set
+// only holds string_views. The id of a string is its index in the set's values, and as strings can't be removed ids are
+// stable.
+class interner {
+    using set_type = set<std::string_view,
+                         detail::arena_key_hash<hash<std::string_view>>,
+                         detail::arena_key_equal<std::equal_to<std::string_view>>>;
+
+    std::unique_ptr<arena> m_chars{}; // created lazily, so moving is noexcept and leaves a usable interner
+    set_type m_set{};
+
+public:
+    using id_type = uint32_t;
+    using const_iterator = set_type::const_iterator;
+
+    interner() = default;
+
+    interner(interner const& other)
+        : interner() {
+        reserve(other.size());
+        for (auto sv : other) {
+            intern(sv);
+        }
+    }
+
+    interner(interner&&) noexcept = default;
+
+    auto operator=(interner const& other) -> interner& {
+        if (&other != this) {
+            auto tmp = other;
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    auto operator=(interner&&) noexcept -> interner& = default;
+
+    ~interner() = default;
+
+    // Returns the id of str, adds it when it's not yet there.
+    auto intern(std::string_view str) -> id_type {
+        if (ANKERL_UNORDERED_DENSE_UNLIKELY(m_set.size() == std::numeric_limits<id_type>::max())) {
+            if (auto it = m_set.find(str); it != m_set.end()) {
+                return static_cast<id_type>(it - m_set.begin());
+            }
+            throw std::overflow_error("ankerl::unordered_dense::interner: too many strings");
+        }
+        auto it = detail::arena_key_try_emplace(m_set, m_chars, str).first;
+        return static_cast<id_type>(it - m_set.begin());
+    }
+
+    // Id of str, or nothing when it wasn't interned
+    [[nodiscard]] auto find(std::string_view str) const -> std::optional<id_type> {
+        if (auto it = m_set.find(str); it != m_set.end()) {
+            return static_cast<id_type>(it - m_set.begin());
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] auto contains(std::string_view str) const -> bool {
+        return m_set.contains(str);
     }
 
-    auto erase(iterator it) -> iterator {
-        auto hash = mixed_hash(get_key(*it));
-        auto bucket_idx = bucket_idx_from_hash(hash);
+    // The string of an id. The string_view stays valid until clear() or destruction of the interner.
+    [[nodiscard]] auto operator[](id_type id) const -> std::string_view {
+        return m_set.values()[id];
+    }
 
-        auto const value_idx_to_remove = static_cast<value_idx_type>(it - cbegin());
-        while (at(m_buckets, bucket_idx).m_value_idx != value_idx_to_remove) {
-            bucket_idx = next(bucket_idx);
+    [[nodiscard]] auto at(id_type id) const -> std::string_view {
+        if (id >= m_set.size()) {
+            throw std::out_of_range("ankerl::unordered_dense::interner::at(): id not found");
         }
+        return m_set.values()[id];
+    }
 
-        do_erase(bucket_idx);
-        return begin() + static_cast<difference_type>(value_idx_to_remove);
+    // iterates all strings in order of their ids
+    [[nodiscard]] auto begin() const noexcept -> const_iterator {
+        return m_set.begin();
     }
 
-    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto erase(const_iterator it) -> iterator {
-        return erase(begin() + (it - cbegin()));
+    [[nodiscard]] auto end() const noexcept -> const_iterator {
+        return m_set.end();
     }
 
-    auto erase(const_iterator first, const_iterator last) -> iterator {
-        auto const idx_first = first - cbegin();
-        auto const idx_last = last - cbegin();
-        auto const first_to_last = std::distance(first, last);
-        auto const last_to_end = std::distance(last, cend());
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return m_set.size();
+    }
 
-        // remove elements from left to right which moves elements from the end back
-        auto const mid = idx_first + std::min(first_to_last, last_to_end);
-        auto idx = idx_first;
-        while (idx != mid) {
-            erase(begin() + idx);
-            ++idx;
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_set.empty();
+    }
+
+    void reserve(size_t count) {
+        m_set.reserve(count);
+    }
+
+    // Removes all strings and makes the character memory available again
+    void clear() {
+        m_set.clear();
+        if (m_chars) {
+            m_chars->reset();
         }
+    }
+};
 
-        // all elements from the right are moved, now remove the last element until all done
-        idx = idx_last;
-        while (idx != mid) {
-            --idx;
-            erase(begin() + idx);
+// string_map /////////////////////////////////////////////////////////////////
+
+// Map with string keys that owns the key's characters. Keys are string_views into an append-only character buffer, so
+// inserting a key doesn't need an allocation per key and destroying the map frees only a few blocks. Erased keys leave
+// garbage in the buffer; it is compacted when the map rehashes or on shrink_to_fit().
+template <class T, class Hash = hash<std::string_view>, class KeyEqual = std::equal_to<std::string_view>>
+class string_map {
+    using map_type = map<std::string_view, T, detail::arena_key_hash<Hash>, detail::arena_key_equal<KeyEqual>>;
+
+    std::unique_ptr<arena> m_chars{}; // created lazily, so moving is noexcept
+    map_type m_map{};
+    size_t m_live_bytes = 0;    // characters of all keys in the map
+    size_t m_garbage_bytes = 0; // characters of erased keys that are still in the buffer
+
+    // Copies all keys into a single new buffer. The keys' contents don't change, so the buckets stay valid.
+    void copy_keys_to_new_buffer() {
+        if (0 == m_live_bytes) {
+            m_chars.reset();
+            m_garbage_bytes = 0;
+            return;
         }
+        auto chars = std::make_unique<arena>(m_live_bytes);
+        auto* out = static_cast<char*>(chars->allocate(m_live_bytes, 1));
+        for (auto& kv : m_map) {
+            auto const size = kv.first.size();
+            if (0 != size) {
+                std::memcpy(out, kv.first.data(), size);
+                kv.first = std::string_view(out, size);
+                out += size;
+            }
+        }
+        m_chars = std::move(chars);
+        m_garbage_bytes = 0;
+    }
 
-        return begin() + idx_first;
+    void compact_if_garbage() {
+        if (0 != m_garbage_bytes) {
+            copy_keys_to_new_buffer();
+        }
     }
 
-    auto erase(Key const& key) -> size_t {
-        return do_erase_key(key);
+    template <typename... Args>
+    auto do_try_emplace(std::string_view key, Args&&... args) -> std::pair<typename map_type::iterator, bool> {
+        auto const num_buckets = m_map.bucket_count();
+        auto [it, is_inserted] = detail::arena_key_try_emplace(m_map, m_chars, key, std::forward<Args>(args)...);
+        if (!is_inserted) {
+            return {it, false};
+        }
+        m_live_bytes += key.size();
+        if (num_buckets != m_map.bucket_count() && 0 != m_garbage_bytes) {
+            auto const idx = it - m_map.begin();
+            copy_keys_to_new_buffer();
+            it = m_map.begin() + idx;
+        }
+        return {it, true};
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto erase(K&& key) -> size_t {
-        return do_erase_key(std::forward<K>(key));
+public:
+    using key_type = std::string_view;
+    using mapped_type = T;
+    using value_type = typename map_type::value_type;
+    using size_type = typename map_type::size_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using iterator = typename map_type::iterator;
+    using const_iterator = typename map_type::const_iterator;
+    using value_container_type = typename map_type::value_container_type;
+
+    string_map() = default;
+
+    string_map(string_map const& other)
+        : m_map(other.m_map)
+        , m_live_bytes(other.m_live_bytes) {
+        copy_keys_to_new_buffer();
     }
 
-    void swap(table& other) noexcept(noexcept(std::is_nothrow_swappable_v<value_container_type>&&
-                                                  std::is_nothrow_swappable_v<Hash>&& std::is_nothrow_swappable_v<KeyEqual>)) {
-        using std::swap;
-        swap(other, *this);
+    string_map(string_map&& other) noexcept
+        : m_chars(std::move(other.m_chars))
+        , m_map(std::move(other.m_map))
+        , m_live_bytes(std::exchange(other.m_live_bytes, 0))
+        , m_garbage_bytes(std::exchange(other.m_garbage_bytes, 0)) {}
+
+    auto operator=(string_map const& other) -> string_map& {
+        if (&other != this) {
+            auto tmp = other;
+            *this = std::move(tmp);
+        }
+        return *this;
     }
 
-    // lookup /////////////////////////////////////////////////////////////////
+    auto operator=(string_map&& other) noexcept -> string_map& {
+        if (&other != this) {
+            m_map = std::move(other.m_map);
+            m_chars = std::move(other.m_chars);
+            m_live_bytes = std::exchange(other.m_live_bytes, 0);
+            m_garbage_bytes = std::exchange(other.m_garbage_bytes, 0);
+        }
+        return *this;
+    }
 
-    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto at(key_type const& key) -> Q& {
-        return do_at(key);
+    ~string_map() = default;
+
+    // iterators //////////////////////////////////////////////////////////////
+
+    auto begin() noexcept -> iterator {
+        return m_map.begin();
     }
 
-    template <typename K,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto at(K const& key) -> Q& {
-        return do_at(key);
+    auto begin() const noexcept -> const_iterator {
+        return m_map.begin();
     }
 
-    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto at(key_type const& key) const -> Q const& {
-        return do_at(key);
+    auto end() noexcept -> iterator {
+        return m_map.end();
     }
 
-    template <typename K,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto at(K const& key) const -> Q const& {
-        return do_at(key);
+    auto end() const noexcept -> const_iterator {
+        return m_map.end();
     }
 
-    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto operator[](Key const& key) -> Q& {
-        return try_emplace(key).first->second;
+    // capacity ///////////////////////////////////////////////////////////////
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_map.empty();
     }
 
-    template <typename Q = T, std::enable_if_t<is_map_v<Q>, bool> = true>
-    auto operator[](Key&& key) -> Q& {
-        return try_emplace(std::move(key)).first->second;
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return m_map.size();
     }
 
-    template <typename K,
-              typename Q = T,
-              typename H = Hash,
-              typename KE = KeyEqual,
-              std::enable_if_t<is_map_v<Q> && is_transparent_v<H, KE>, bool> = true>
-    auto operator[](K&& key) -> Q& {
-        return try_emplace(std::forward<K>(key)).first->second;
+    // Bytes in the character buffer, including the garbage of erased keys
+    [[nodiscard]] auto key_bytes() const noexcept -> size_t {
+        return m_live_bytes + m_garbage_bytes;
     }
 
-    auto count(Key const& key) const -> size_t {
-        return find(key) == end() ? 0 : 1;
+    // modifiers //////////////////////////////////////////////////////////////
+
+    void clear() {
+        m_map.clear();
+        if (m_chars) {
+            m_chars->reset();
+        }
+        m_live_bytes = 0;
+        m_garbage_bytes = 0;
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto count(K const& key) const -> size_t {
-        return find(key) == end() ? 0 : 1;
+    template <typename... Args>
+    auto try_emplace(std::string_view key, Args&&... args) -> std::pair<iterator, bool> {
+        return do_try_emplace(key, std::forward<Args>(args)...);
     }
 
-    auto find(Key const& key) -> iterator {
-        return do_find(key);
+    template <typename M>
+    auto insert_or_assign(std::string_view key, M&& mapped) -> std::pair<iterator, bool> {
+        auto it_isinserted = do_try_emplace(key, std::forward<M>(mapped));
+        if (!it_isinserted.second) {
+            it_isinserted.first->second = std::forward<M>(mapped);
+        }
+        return it_isinserted;
     }
 
-    auto find(Key const& key) const -> const_iterator {
-        return do_find(key);
+    auto insert(value_type const& value) -> std::pair<iterator, bool> {
+        return do_try_emplace(value.first, value.second);
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto find(K const& key) -> iterator {
-        return do_find(key);
+    auto insert(value_type&& value) -> std::pair<iterator, bool> {
+        return do_try_emplace(value.first, std::move(value.second));
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto find(K const& key) const -> const_iterator {
-        return do_find(key);
+    auto erase(const_iterator it) -> iterator {
+        auto const key = it->first;
+        auto result = m_map.erase(it);
+        m_live_bytes -= key.size();
+        m_garbage_bytes += key.size();
+        return result;
     }
 
-    auto contains(Key const& key) const -> bool {
-        return find(key) != end();
+    auto erase(std::string_view key) -> size_t {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto contains(K const& key) const -> bool {
-        return find(key) != end();
+    void swap(string_map& other) noexcept {
+        using std::swap;
+        swap(m_chars, other.m_chars);
+        swap(m_map, other.m_map);
+        swap(m_live_bytes, other.m_live_bytes);
+        swap(m_garbage_bytes, other.m_garbage_bytes);
     }
 
-    auto equal_range(Key const& key) -> std::pair<iterator, iterator> {
-        auto it = do_find(key);
-        return {it, it == end() ? end() : it + 1};
+    // lookup /////////////////////////////////////////////////////////////////
+
+    auto at(std::string_view key) -> T& {
+        return m_map.at(key);
     }
 
-    auto equal_range(const Key& key) const -> std::pair<const_iterator, const_iterator> {
-        auto it = do_find(key);
-        return {it, it == end() ? end() : it + 1};
+    auto at(std::string_view key) const -> T const& {
+        return m_map.at(key);
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto equal_range(K const& key) -> std::pair<iterator, iterator> {
-        auto it = do_find(key);
-        return {it, it == end() ? end() : it + 1};
+    auto operator[](std::string_view key) -> T& {
+        return do_try_emplace(key).first->second;
     }
 
-    template <class K, class H = Hash, class KE = KeyEqual, std::enable_if_t<is_transparent_v<H, KE>, bool> = true>
-    auto equal_range(K const& key) const -> std::pair<const_iterator, const_iterator> {
-        auto it = do_find(key);
-        return {it, it == end() ? end() : it + 1};
+    auto find(std::string_view key) -> iterator {
+        return m_map.find(key);
     }
 
-    // bucket interface ///////////////////////////////////////////////////////
+    auto find(std::string_view key) const -> const_iterator {
+        return m_map.find(key);
+    }
 
-    auto bucket_count() const noexcept -> size_t { // NOLINT(modernize-use-nodiscard)
-        return m_num_buckets;
+    [[nodiscard]] auto count(std::string_view key) const -> size_t {
+        return m_map.count(key);
     }
 
-    static constexpr auto max_bucket_count() noexcept -> size_t { // NOLINT(modernize-use-nodiscard)
-        return max_size();
+    [[nodiscard]] auto contains(std::string_view key) const -> bool {
+        return m_map.contains(key);
+    }
+
+    // bucket interface ///////////////////////////////////////////////////////
+
+    [[nodiscard]] auto bucket_count() const noexcept -> size_t {
+        return m_map.bucket_count();
     }
 
     // hash policy ////////////////////////////////////////////////////////////
 
     [[nodiscard]] auto load_factor() const -> float {
-        return bucket_count() ? static_cast<float>(size()) / static_cast<float>(bucket_count()) : 0.0F;
+        return m_map.load_factor();
     }
 
     [[nodiscard]] auto max_load_factor() const -> float {
-        return m_max_load_factor;
+        return m_map.max_load_factor();
     }
 
     void max_load_factor(float ml) {
-        m_max_load_factor = ml;
-        if (m_num_buckets != max_bucket_count()) {
-            m_max_bucket_capacity = static_cast<value_idx_type>(static_cast<float>(bucket_count()) * max_load_factor());
-        }
+        m_map.max_load_factor(ml);
     }
 
     void rehash(size_t count) {
-        count = std::min(count, max_size());
-        auto shifts = calc_shifts_for_size(std::max(count, size()));
-        if (shifts != m_shifts) {
-            m_shifts = shifts;
-            deallocate_buckets();
-            m_values.shrink_to_fit();
-            allocate_buckets_from_shift();
-            clear_and_fill_buckets_from_values();
-        }
+        compact_if_garbage();
+        m_map.rehash(count);
     }
 
     void reserve(size_t capa) {
-        capa = std::min(capa, max_size());
-        if constexpr (has_reserve<value_container_type>) {
-            // std::deque doesn't have reserve(). Make sure we only call when available
-            m_values.reserve(capa);
-        }
-        auto shifts = calc_shifts_for_size(std::max(capa, size()));
-        if (0 == m_num_buckets || shifts < m_shifts) {
-            m_shifts = shifts;
-            deallocate_buckets();
-            allocate_buckets_from_shift();
-            clear_and_fill_buckets_from_values();
-        }
+        m_map.reserve(capa);
+    }
+
+    // Shrinks the buckets & values to the size, and copies all keys into a single buffer without garbage.
+    void shrink_to_fit() {
+        m_map.rehash(0);
+        copy_keys_to_new_buffer();
     }
 
     // observers //////////////////////////////////////////////////////////////
 
-    auto hash_function() const -> hasher {
-        return m_hash;
+    [[nodiscard]] auto hash_function() const -> hasher {
+        return m_map.hash_function();
     }
 
-    auto key_eq() const -> key_equal {
-        return m_equal;
+    [[nodiscard]] auto key_eq() const -> key_equal {
+        return m_map.key_eq();
     }
 
-    // nonstandard API: expose the underlying values container
+    // nonstandard API: the string_views of the keys point into the map's buffer
     [[nodiscard]] auto values() const noexcept -> value_container_type const& {
-        return m_values;
+        return m_map.values();
     }
 
-    // non-member functions ///////////////////////////////////////////////////
+    [[nodiscard]] auto stats() const -> table_stats {
+        return m_map.stats();
+    }
 
-    friend auto operator==(table const& a, table const& b) -> bool {
-        if (&a == &b) {
-            return true;
-        }
-        if (a.size() != b.size()) {
-            return false;
-        }
-        for (auto const& b_entry : b) {
-            auto it = a.find(get_key(b_entry));
-            if constexpr (is_map_v<T>) {
-                // map: check that key is here, then also check that value is the same
-                if (a.end() == it || !(b_entry.second == it->second)) {
-                    return false;
-                }
-            } else {
-                // set: only check that the key is here
-                if (a.end() == it) {
-                    return false;
-                }
-            }
+    // The key characters are counted in heap_bytes, including garbage and unused space of the buffer.
+    [[nodiscard]] auto memory_usage() const noexcept -> table_memory {
+        auto mem = m_map.memory_usage();
+        if (m_chars) {
+            mem.heap_bytes += m_chars->capacity();
+            mem.total_bytes += m_chars->capacity();
         }
-        return true;
+        return mem;
     }
 
-    friend auto operator!=(table const& a, table const& b) -> bool {
-        return !(a == b);
+#    if ANKERL_UNORDERED_DENSE_STATS
+    [[nodiscard]] auto counters() const noexcept -> table_counters {
+        return m_map.counters();
     }
-};
 
-} // namespace detail
+    void reset_counters() noexcept {
+        m_map.reset_counters();
+    }
+#    endif
 
-template <class Key,
-          class T,
-          class Hash = hash<Key>,
-          class KeyEqual = std::equal_to<Key>,
-          class AllocatorOrContainer = std::allocator<std::pair<Key, T>>,
-          class Bucket = bucket_type::standard>
-using map = detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket>;
+    // non-member functions ///////////////////////////////////////////////////
 
-template <class Key,
-          class Hash = hash<Key>,
-          class KeyEqual = std::equal_to<Key>,
-          class AllocatorOrContainer = std::allocator<Key>,
-          class Bucket = bucket_type::standard>
-using set = detail::table<Key, void, Hash, KeyEqual, AllocatorOrContainer, Bucket>;
+    friend auto operator==(string_map const& a, string_map const& b) -> bool {
+        return a.m_map == b.m_map;
+    }
+
+    friend auto operator!=(string_map const& a, string_map const& b) -> bool {
+        return !(a == b);
+    }
+};
 
 #    if ANKERL_UNORDERED_DENSE_PMR
 
@@ -1490,11 +4213,16 @@ template <class Key,
           class T,
           class Hash = hash<Key>,
           class KeyEqual = std::equal_to<Key>,
-          class Bucket = bucket_type::standard>
-using map = detail::table<Key, T, Hash, KeyEqual, ANKERL_UNORDERED_DENSE_PMR_ALLOCATOR<std::pair<Key, T>>, Bucket>;
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using map = detail::table<Key, T, Hash, KeyEqual, ANKERL_UNORDERED_DENSE_PMR_ALLOCATOR<std::pair<Key, T>>, Bucket, Observer>;
 
-template <class Key, class Hash = hash<Key>, class KeyEqual = std::equal_to<Key>, class Bucket = bucket_type::standard>
-using set = detail::table<Key, void, Hash, KeyEqual, ANKERL_UNORDERED_DENSE_PMR_ALLOCATOR<Key>, Bucket>;
+template <class Key,
+          class Hash = hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Bucket = bucket_type::standard,
+          class Observer = no_observer>
+using set = detail::table<Key, void, Hash, KeyEqual, ANKERL_UNORDERED_DENSE_PMR_ALLOCATOR<Key>, Bucket, Observer>;
 
 } // namespace pmr
 
@@ -1512,10 +4240,10 @@ using set = detail::table<Key, void, Hash, KeyEqual, ANKERL_UNORDERED_DENSE_PMR_
 
 namespace std { // NOLINT(cert-dcl58-cpp)
 
-template <class Key, class T, class Hash, class KeyEqual, class AllocatorOrContainer, class Bucket, class Pred>
-auto erase_if(ankerl::unordered_dense::detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket>& map, Pred pred)
-    -> size_t {
-    using map_t = ankerl::unordered_dense::detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket>;
+template <class Key, class T, class Hash, class KeyEqual, class AllocatorOrContainer, class Bucket, class Observer, class Pred>
+auto erase_if(ankerl::unordered_dense::detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket, Observer>& map,
+              Pred pred) -> size_t {
+    using map_t = ankerl::unordered_dense::detail::table<Key, T, Hash, KeyEqual, AllocatorOrContainer, Bucket, Observer>;
 
     // going back to front because erase() invalidates the end iterator
     auto const old_size = map.size();
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef> // for size_t
+#include <cstdlib> // for getenv, strtoull
+
+// Size of a benchmark from environment variable varname, or default_value when it isn't set
+[[nodiscard]] inline auto env_or(char const* varname, size_t default_value) -> size_t {
+    auto const* str = std::getenv(varname); // NOLINT(concurrency-mt-unsafe)
+    if (nullptr == str) {
+        return default_value;
+    }
+    return static_cast<size_t>(std::strtoull(str, nullptr, 10));
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+
+#include <cstdint> // for uint64_t
+
+// True when Hash declares is_avalanching, so the map uses its result without mixing it again
+template <typename Hash>
+constexpr bool is_avalanching_hash_v =
+    ankerl::unordered_dense::detail::is_detected_v<ankerl::unordered_dense::detail::detect_avalanching, Hash>;
+
+template <typename T>
+constexpr bool is_avalanching_v = is_avalanching_hash_v<ankerl::unordered_dense::hash<T>>;
+
+template <typename T>
+[[nodiscard]] auto hash_of(T const& obj) -> uint64_t {
+    return ankerl::unordered_dense::hash<T>{}(obj);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <third-party/nanobench.h> // for Rng
+
+#include <algorithm> // for lower_bound, min
+#include <cmath>     // for pow
+#include <cstddef>   // for size_t
+#include <vector>    // for vector
+
+// Draws ranks 0..n-1 with Zipf distribution by binary search in the cumulative distribution. Rank i has probability
+// proportional to 1 / (i + 1)^s: s = 0 is uniform, s = 1 is classic Zipf, larger is more skewed.
+class zipf_distribution {
+    std::vector<double> m_cdf{};
+
+public:
+    zipf_distribution(size_t n, double s)
+        : m_cdf(n) {
+        auto sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+            m_cdf[i] = sum;
+        }
+        for (auto& c : m_cdf) {
+            c /= sum;
+        }
+    }
+
+    [[nodiscard]] auto operator()(ankerl::nanobench::Rng& rng) const -> size_t {
+        auto it = std::lower_bound(m_cdf.begin(), m_cdf.end(), rng.uniform01());
+        return std::min(static_cast<size_t>(it - m_cdf.begin()), m_cdf.size() - 1);
+    }
+};
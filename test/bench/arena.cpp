@@ -0,0 +1,89 @@
+#include <ankerl/unordered_dense.h> // for map, arena_map, arena, bucket_recycler
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace {
+
+constexpr size_t num_maps = 1000;
+constexpr size_t num_inserts = 100;
+
+// Simulates a request: creates many short lived maps, and then drops all of them at once.
+template <typename Map, typename MakeMap, typename Reset>
+void bench(std::string_view name, MakeMap make_map, Reset reset) {
+    auto rng = ankerl::nanobench::Rng(123);
+    ankerl::nanobench::Bench().batch(num_maps * num_inserts).run(fmt::format("arena {}", name), [&] {
+        {
+            auto maps = std::vector<Map>();
+            maps.reserve(num_maps);
+            for (size_t i = 0; i < num_maps; ++i) {
+                auto& map = maps.emplace_back(make_map());
+                for (size_t j = 0; j < num_inserts; ++j) {
+                    map[rng.bounded(num_inserts * 2)] += j;
+                }
+            }
+            ankerl::nanobench::doNotOptimizeAway(maps.back().size());
+        }
+        reset();
+    });
+}
+
+} // namespace
+
+TEST_CASE("bench_arena_std_allocator" * doctest::test_suite("bench") * doctest::skip()) {
+    using map_t = ankerl::unordered_dense::map<uint64_t, uint64_t>;
+    bench<map_t>(
+        "std::allocator",
+        [] {
+            return map_t();
+        },
+        [] {});
+}
+
+TEST_CASE("bench_arena_bucket_recycler" * doctest::test_suite("bench") * doctest::skip()) {
+    using map_t = ankerl::unordered_dense::map<uint64_t, uint64_t>;
+    auto recycler = ankerl::unordered_dense::bucket_recycler();
+    bench<map_t>(
+        "std::allocator with bucket_recycler",
+        [] {
+            return map_t();
+        },
+        [] {});
+}
+
+#if ANKERL_UNORDERED_DENSE_PMR && __has_include(<memory_resource>)
+
+TEST_CASE("bench_arena_pmr_monotonic" * doctest::test_suite("bench") * doctest::skip()) {
+    using map_t = ankerl::unordered_dense::pmr::map<uint64_t, uint64_t>;
+    auto mr = std::pmr::monotonic_buffer_resource();
+    bench<map_t>(
+        "pmr::monotonic_buffer_resource",
+        [&] {
+            return map_t(&mr);
+        },
+        [&] {
+            mr.release();
+        });
+}
+
+#endif
+
+TEST_CASE("bench_arena_arena_map" * doctest::test_suite("bench") * doctest::skip()) {
+    using map_t = ankerl::unordered_dense::arena_map<uint64_t, uint64_t>;
+    auto a = ankerl::unordered_dense::arena();
+    bench<map_t>(
+        "arena_map",
+        [&] {
+            return map_t(a);
+        },
+        [&] {
+            a.reset();
+        });
+}
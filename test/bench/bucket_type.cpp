@@ -0,0 +1,81 @@
+#include <ankerl/unordered_dense.h> // for map, hash
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t, UINT64_C
+#include <functional>  // for equal_to
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+// Cost of fingerprint collisions for URL keys at a high load factor: each collision compares with a stored std::string,
+// which reads the value and the key's heap buffer.
+
+namespace {
+
+constexpr size_t num_keys = 500000;
+
+// the hash without the lower byte, so the fingerprint is always 0 and every probed bucket with the same distance needs a
+// key comparison
+struct hash_without_fingerprint {
+    using is_avalanching = void;
+
+    auto operator()(std::string const& str) const noexcept -> uint64_t {
+        return ankerl::unordered_dense::hash<std::string>{}(str) & ~UINT64_C(0xFF);
+    }
+};
+
+// URL like keys that share a long prefix, too long for the small string optimization
+auto make_keys(size_t begin, size_t end) -> std::vector<std::string> {
+    auto keys = std::vector<std::string>();
+    for (size_t i = begin; i < end; ++i) {
+        keys.push_back(fmt::format("https://example.com/api/v2/items/{}", i));
+    }
+    return keys;
+}
+
+template <typename Hash>
+void bench_find(std::string_view name) {
+    auto map = ankerl::unordered_dense::map<std::string, size_t, Hash, std::equal_to<std::string>>();
+    map.max_load_factor(0.95F);
+    auto hits = make_keys(0, num_keys);
+    for (auto const& key : hits) {
+        map.try_emplace(key, map.size());
+    }
+    auto st = map.stats();
+    fmt::print("{}: mean probe length {:.3f}, fingerprint collision rate {:.6f}, {} bytes in buckets\n",
+               name,
+               st.mean_probe_length,
+               st.fingerprint_collision_rate,
+               st.bucket_bytes);
+    auto rng = ankerl::nanobench::Rng(123);
+    rng.shuffle(hits);
+
+    auto const misses = make_keys(num_keys, num_keys * 2);
+    ankerl::nanobench::Bench().minEpochIterations(5).batch(misses.size()).run(fmt::format("find miss {}", name), [&] {
+        size_t found = 0;
+        for (auto const& key : misses) {
+            found += map.count(key);
+        }
+        ankerl::nanobench::doNotOptimizeAway(found);
+    });
+
+    ankerl::nanobench::Bench().minEpochIterations(5).batch(hits.size()).run(fmt::format("find hit {}", name), [&] {
+        size_t sum = 0;
+        for (auto const& key : hits) {
+            sum += map.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+} // namespace
+
+TEST_CASE("bench_bucket_type_string_miss" * doctest::test_suite("bench") * doctest::skip()) {
+    bench_find<ankerl::unordered_dense::hash<std::string>>("hash");
+    bench_find<hash_without_fingerprint>("hash without fingerprint");
+}
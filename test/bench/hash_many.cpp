@@ -0,0 +1,34 @@
+// measure the AVX2 code, not just the portable fallback
+#define ANKERL_UNORDERED_DENSE_X86_DISPATCH // NOLINT(cppcoreguidelines-macro-usage)
+#include <ankerl/unordered_dense.h> // for hash, hash_many
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h> // for TestCase, skip, TEST_CASE, test_...
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+#include <vector>  // for vector
+
+TEST_CASE("bench_hash_many" * doctest::test_suite("bench") * doctest::skip()) {
+    static constexpr size_t num_keys = 4096;
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<uint64_t>();
+    for (size_t i = 0; i < num_keys; ++i) {
+        keys.push_back(rng());
+    }
+    auto hashes = std::vector<uint64_t>(num_keys);
+
+    auto bench = ankerl::nanobench::Bench().batch(num_keys).unit("key").relative(true);
+    bench.run("hash one by one", [&] {
+        auto h = ankerl::unordered_dense::hash<uint64_t>();
+        for (size_t i = 0; i < num_keys; ++i) {
+            hashes[i] = h(keys[i]);
+        }
+        ankerl::nanobench::doNotOptimizeAway(hashes.data());
+    });
+    bench.run("hash_many", [&] {
+        ankerl::unordered_dense::hash_many(keys.data(), keys.size(), hashes.data());
+        ankerl::nanobench::doNotOptimizeAway(hashes.data());
+    });
+}
@@ -0,0 +1,116 @@
+#include <ankerl/unordered_dense.h> // for map, hash, hash_fibonacci, hash_identity_avalanching, hash_murmur_fmix
+
+#include <app/name_of_type.h>      // for name_of_type
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace {
+
+constexpr size_t num_keys = 100000;
+
+auto make_keys(std::string_view distribution) -> std::vector<uint64_t> {
+    auto keys = std::vector<uint64_t>();
+    auto rng = ankerl::nanobench::Rng(123);
+    for (uint64_t i = 0; i < num_keys; ++i) {
+        if (distribution == "sequential") {
+            keys.push_back(i);
+        } else if (distribution == "random") {
+            keys.push_back(rng());
+        } else {
+            // e.g. addresses of 4 KiB aligned objects
+            keys.push_back(i << 12U);
+        }
+    }
+    return keys;
+}
+
+// Beyond that the distribution is considered degenerate, and runtime would be quadratic.
+constexpr size_t max_probe_length = 1000;
+
+// Robin-hood insertion of a degenerate distribution is quadratic, so first simulate linear probing with the map's bucket
+// count (home bucket is the upper bits of the hash) to find out if the hash is usable for these keys. The sum of all probe
+// lengths doesn't depend on the order of insertion. Returns true when the hash is degenerate.
+template <typename Hash>
+auto is_degenerate(std::vector<uint64_t> const& keys) -> bool {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t, Hash>();
+    map.reserve(keys.size());
+    auto num_buckets = map.bucket_count();
+    auto shifts = 64U;
+    while ((size_t{1} << (64U - shifts)) < num_buckets) {
+        --shifts;
+    }
+
+    auto occupied = std::vector<bool>(num_buckets);
+    for (auto key : keys) {
+        auto idx = static_cast<size_t>(Hash{}(key) >> shifts);
+        size_t dist = 0;
+        while (occupied[idx]) {
+            idx = idx + 1 == num_buckets ? 0 : idx + 1;
+            if (++dist > max_probe_length) {
+                return true;
+            }
+        }
+        occupied[idx] = true;
+    }
+    return false;
+}
+
+template <typename Hash>
+auto print_stats(std::string_view distribution, std::vector<uint64_t> const& keys) -> bool {
+    if (is_degenerate<Hash>(keys)) {
+        fmt::print("{:>12} {:>70}: degenerate, probe length > {}\n", distribution, name_of_type<Hash>(), max_probe_length);
+        return false;
+    }
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t, Hash>();
+    for (auto key : keys) {
+        map[key] = key;
+    }
+    auto st = map.stats();
+    fmt::print("{:>12} {:>70}: mean probe length {:6.3f}, max {:4}, fingerprint collisions {:6.4f}\n",
+               distribution,
+               name_of_type<Hash>(),
+               st.mean_probe_length,
+               st.max_probe_length,
+               st.fingerprint_collision_rate);
+    return true;
+}
+
+template <typename Hash>
+void bench(ankerl::nanobench::Bench& bench, std::string_view distribution, std::vector<uint64_t> const& keys) {
+    bench.run(fmt::format("{} {}", distribution, name_of_type<Hash>()), [&] {
+        auto map = ankerl::unordered_dense::map<uint64_t, uint64_t, Hash>();
+        for (auto key : keys) {
+            map[key] = key;
+        }
+        uint64_t sum = 0;
+        for (auto key : keys) {
+            sum += map.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+template <typename... Hashes>
+void bench_all() {
+    auto b = ankerl::nanobench::Bench().batch(num_keys * 2).unit("op").relative(true);
+    for (auto distribution : {"sequential", "random", "strided"}) {
+        auto keys = make_keys(distribution);
+        ((print_stats<Hashes>(distribution, keys) ? bench<Hashes>(b, distribution, keys) : void()), ...);
+    }
+}
+
+} // namespace
+
+TEST_CASE("bench_hash_policies" * doctest::test_suite("bench") * doctest::skip()) {
+    bench_all<ankerl::unordered_dense::hash<uint64_t>,
+              ankerl::unordered_dense::hash_identity_avalanching<uint64_t>,
+              ankerl::unordered_dense::hash_fibonacci<uint64_t>,
+              ankerl::unordered_dense::hash_murmur_fmix<uint64_t>>();
+}
@@ -0,0 +1,89 @@
+// measure the AES-NI code, not just the portable fallback
+#define ANKERL_UNORDERED_DENSE_X86_DISPATCH // NOLINT(cppcoreguidelines-macro-usage)
+#include <ankerl/unordered_dense.h> // for hash, hash_aes
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <algorithm>   // for max
+#include <array>       // for array
+#include <cmath>       // for abs
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t, uint8_t
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace {
+
+constexpr auto key_lengths = std::array<size_t, 9>{4, 8, 16, 24, 32, 64, 128, 256, 1024};
+
+template <typename Hash>
+void bench_throughput(ankerl::nanobench::Bench& bench, std::string_view name, size_t len) {
+    static constexpr size_t num_keys = 1000;
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<std::string>();
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto& str = keys.emplace_back(len, 'x');
+        for (auto& c : str) {
+            c = static_cast<char>(rng());
+        }
+    }
+    auto h = Hash();
+    bench.batch(num_keys * len).run(fmt::format("{:>5} bytes {}", len, name), [&] {
+        uint64_t sum = 0;
+        for (auto const& key : keys) {
+            sum += h(key);
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+// Flips each input bit and counts how often each output bit changes. Ideally that's 50%, reports the worst deviation.
+template <typename Hash>
+void print_avalanche(std::string_view name, size_t len) {
+    static constexpr size_t num_samples = 500;
+    auto rng = ankerl::nanobench::Rng(123);
+    auto h = Hash();
+    auto flips = std::vector<size_t>(len * 8 * 64);
+    auto str = std::string(len, 'x');
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+        for (auto& c : str) {
+            c = static_cast<char>(rng());
+        }
+        auto const base = h(str);
+        for (size_t bit = 0; bit < len * 8; ++bit) {
+            auto const mask = static_cast<char>(1U << (bit % 8));
+            str[bit / 8] ^= mask;
+            auto diff = base ^ h(str);
+            str[bit / 8] ^= mask;
+            for (size_t out = 0; out < 64; ++out) {
+                flips[bit * 64 + out] += (diff >> out) & 1U;
+            }
+        }
+    }
+    auto worst = 0.0;
+    for (auto f : flips) {
+        worst = std::max(worst, std::abs(static_cast<double>(f) / num_samples - 0.5));
+    }
+    fmt::print("{:>5} bytes {:>10}: worst avalanche bias {:.3f}\n", len, name, worst);
+}
+
+} // namespace
+
+TEST_CASE("bench_hash_string" * doctest::test_suite("bench") * doctest::skip()) {
+#if ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH
+    fmt::print("AES-NI {}supported\n", ankerl::unordered_dense::detail::aes::is_supported() ? "" : "NOT ");
+#endif
+    auto bench = ankerl::nanobench::Bench().unit("byte");
+    for (auto len : key_lengths) {
+        bench_throughput<ankerl::unordered_dense::hash<std::string>>(bench, "wyhash", len);
+        bench_throughput<ankerl::unordered_dense::hash_aes<std::string>>(bench, "hash_aes", len);
+    }
+    for (auto len : {size_t{8}, size_t{32}, size_t{100}}) {
+        print_avalanche<ankerl::unordered_dense::hash<std::string>>("wyhash", len);
+        print_avalanche<ankerl::unordered_dense::hash_aes<std::string>>("hash_aes", len);
+    }
+}
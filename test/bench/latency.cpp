@@ -0,0 +1,267 @@
+#include <ankerl/unordered_dense.h> // for map
+
+#include <app/env_or.h>             // for env_or
+#include <third-party/nanobench.h>  // for Rng, doNotOptimizeAway
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <algorithm>     // for max, min
+#include <array>         // for array
+#include <chrono>        // for steady_clock, nanoseconds
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <functional>    // for equal_to
+#include <memory>        // for allocator
+#include <string>        // for string
+#include <string_view>   // for string_view
+#include <unordered_map> // for unordered_map
+#include <utility>       // for pair
+#include <vector>        // for vector
+
+// Times each single operation and reports percentiles, so the rare slow operations (rehash, growing the values vector)
+// that averages hide become visible. Number of operations per scenario is BENCH_LATENCY_SIZE, default 1000000.
+
+namespace {
+
+// Log-linear histogram like HdrHistogram: values below 64 are exact, above that each power of two is split into 32
+// buckets, so a reported value is at most ~3% larger than the real one.
+class latency_histogram {
+    static constexpr size_t sub_buckets = 32;
+
+    std::array<uint64_t, 64 * sub_buckets> m_counts{};
+    uint64_t m_num = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_max = 0;
+
+    [[nodiscard]] static auto shift_of(uint64_t value) -> size_t {
+        size_t shift = 0;
+        while ((value >> shift) >= 2 * sub_buckets) {
+            ++shift;
+        }
+        return shift;
+    }
+
+    [[nodiscard]] static auto index_of(uint64_t value) -> size_t {
+        auto const shift = shift_of(value);
+        return shift * sub_buckets + static_cast<size_t>(value >> shift);
+    }
+
+    // largest value that falls into the bucket
+    [[nodiscard]] static auto highest_value_of(size_t idx) -> uint64_t {
+        if (idx < 2 * sub_buckets) {
+            return idx;
+        }
+        auto const shift = idx / sub_buckets - 1;
+        auto const sub = idx - shift * sub_buckets;
+        return ((uint64_t{sub} + 1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        ++m_counts[index_of(value)];
+        ++m_num;
+        m_sum += value;
+        m_max = std::max(m_max, value);
+    }
+
+    // p in [0, 1]
+    [[nodiscard]] auto percentile(double p) const -> uint64_t {
+        auto const target = static_cast<uint64_t>(p * static_cast<double>(m_num));
+        uint64_t seen = 0;
+        for (size_t idx = 0; idx < m_counts.size(); ++idx) {
+            seen += m_counts[idx];
+            if (seen > target) {
+                return std::min(highest_value_of(idx), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    [[nodiscard]] auto max() const -> uint64_t {
+        return m_max;
+    }
+
+    [[nodiscard]] auto mean() const -> double {
+        return m_num == 0 ? 0.0 : static_cast<double>(m_sum) / static_cast<double>(m_num);
+    }
+
+    [[nodiscard]] auto num() const -> uint64_t {
+        return m_num;
+    }
+};
+
+// Records how long op takes in ns, including the time to read the clock (see clock_overhead())
+template <typename Op>
+auto timed(latency_histogram& hist, Op op) {
+    auto const before = std::chrono::steady_clock::now();
+    auto result = op();
+    auto const after = std::chrono::steady_clock::now();
+    hist.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+    return result;
+}
+
+[[nodiscard]] auto clock_overhead() -> latency_histogram {
+    auto hist = latency_histogram();
+    for (size_t i = 0; i < 100000; ++i) {
+        timed(hist, [] {
+            return 0;
+        });
+    }
+    return hist;
+}
+
+void print_header() {
+    fmt::print("| {:>10} | {:>10} | {:>10} | {:>10} | {:>12} | {:>10} | scenario\n", "p50 ns", "p99 ns", "p99.9 ns", "max ns",
+               "mean ns", "ops");
+    fmt::print("|-----------:|-----------:|-----------:|-----------:|-------------:|-----------:|:---------\n");
+}
+
+void print_row(std::string_view name, latency_histogram const& hist) {
+    fmt::print("| {:>10} | {:>10} | {:>10} | {:>10} | {:>12.1f} | {:>10} | `{}`\n",
+               hist.percentile(0.5),
+               hist.percentile(0.99),
+               hist.percentile(0.999),
+               hist.max(),
+               hist.mean(),
+               hist.num(),
+               name);
+}
+
+[[nodiscard]] auto num_ops() -> size_t {
+    return env_or("BENCH_LATENCY_SIZE", 1000000);
+}
+
+template <typename Map>
+void bench(std::string_view name) {
+    auto const n = num_ops();
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<uint64_t>(n);
+    for (auto& key : keys) {
+        key = rng();
+    }
+
+    // insert from empty: includes every rehash and growth of the map
+    auto map = Map();
+    auto insert_hist = latency_histogram();
+    for (auto key : keys) {
+        timed(insert_hist, [&] {
+            return map.try_emplace(key, key).second;
+        });
+    }
+    print_row(fmt::format("{} insert from empty", name), insert_hist);
+
+    auto shuffled = keys;
+    rng.shuffle(shuffled);
+    auto find_hist = latency_histogram();
+    uint64_t sum = 0;
+    for (auto key : shuffled) {
+        sum += timed(find_hist, [&] {
+            return map.find(key)->second;
+        });
+    }
+    ankerl::nanobench::doNotOptimizeAway(sum);
+    print_row(fmt::format("{} find", name), find_hist);
+
+    // steady state churn: the size stays the same, each step erases a random element and inserts a new one
+    auto churn_erase_hist = latency_histogram();
+    auto churn_insert_hist = latency_histogram();
+    for (size_t i = 0; i < n; ++i) {
+        auto& key = keys[rng.bounded(static_cast<uint32_t>(n))];
+        timed(churn_erase_hist, [&] {
+            return map.erase(key);
+        });
+        key = rng();
+        timed(churn_insert_hist, [&] {
+            return map.try_emplace(key, key).second;
+        });
+    }
+    REQUIRE(map.size() == n);
+    print_row(fmt::format("{} churn erase", name), churn_erase_hist);
+    print_row(fmt::format("{} churn insert", name), churn_insert_hist);
+
+    // erase sweep: removes all elements in random order
+    rng.shuffle(keys);
+    auto erase_hist = latency_histogram();
+    for (auto key : keys) {
+        timed(erase_hist, [&] {
+            return map.erase(key);
+        });
+    }
+    REQUIRE(map.empty());
+    print_row(fmt::format("{} erase sweep", name), erase_hist);
+}
+
+// Attributes the slowest inserts of ankerl::unordered_dense::map to rehashes and growth of the values vector. It only
+// runs in a separate pass, so the timed maps all run without an observer.
+struct growth_log {
+    static inline size_t num_rehashes = 0;                          // NOLINT
+    static inline std::chrono::nanoseconds longest_rehash{};        // NOLINT
+    static inline size_t num_values_growths = 0;                    // NOLINT
+    static inline std::chrono::nanoseconds longest_values_growth{}; // NOLINT
+
+    static void on_rehash(ankerl::unordered_dense::rehash_event const& event) noexcept {
+        ++num_rehashes;
+        longest_rehash = std::max(longest_rehash, event.duration);
+    }
+
+    static void on_values_growth(ankerl::unordered_dense::values_growth_event const& event) noexcept {
+        ++num_values_growths;
+        longest_values_growth = std::max(longest_values_growth, event.duration);
+    }
+};
+
+// Inserts the same keys as the "insert from empty" scenario of bench(), untimed, into a map with growth_log
+void attribute_growth() {
+    using map_t = ankerl::unordered_dense::map<uint64_t,
+                                               uint64_t,
+                                               ankerl::unordered_dense::hash<uint64_t>,
+                                               std::equal_to<uint64_t>,
+                                               std::allocator<std::pair<uint64_t, uint64_t>>,
+                                               ankerl::unordered_dense::bucket_type::standard,
+                                               growth_log>;
+
+    auto const n = num_ops();
+    auto rng = ankerl::nanobench::Rng(123);
+    auto map = map_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto const key = rng();
+        map.try_emplace(key, key);
+    }
+    fmt::print("ankerl::unordered_dense::map: {} rehashes, longest {}ns; {} values growths, longest {}ns\n",
+               growth_log::num_rehashes,
+               growth_log::longest_rehash.count(),
+               growth_log::num_values_growths,
+               growth_log::longest_values_growth.count());
+}
+
+} // namespace
+
+TEST_CASE("bench_latency" * doctest::test_suite("bench") * doctest::skip()) {
+    print_header();
+    print_row("steady_clock::now() overhead", clock_overhead());
+    bench<ankerl::unordered_dense::map<uint64_t, uint64_t>>("ankerl::unordered_dense::map");
+    bench<robin_hood::unordered_flat_map<uint64_t, uint64_t>>("robin_hood::unordered_flat_map");
+    bench<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map");
+    attribute_growth();
+}
+
+TEST_CASE("latency_histogram") {
+    auto hist = latency_histogram();
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        hist.record(i);
+    }
+    REQUIRE(hist.num() == 1000);
+    REQUIRE(hist.max() == 1000);
+    REQUIRE(hist.mean() == doctest::Approx(500.5));
+    // within the histogram's precision
+    REQUIRE(hist.percentile(0.5) >= 500);
+    REQUIRE(hist.percentile(0.5) <= 516);
+    REQUIRE(hist.percentile(0.99) >= 990);
+    REQUIRE(hist.percentile(0.99) <= 1000);
+    REQUIRE(hist.percentile(1.0) == 1000);
+
+    hist.record(uint64_t{1} << 62U);
+    REQUIRE(hist.max() == uint64_t{1} << 62U);
+}
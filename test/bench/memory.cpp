@@ -0,0 +1,289 @@
+#include <ankerl/unordered_dense.h> // for map
+
+#include <app/env_or.h>             // for env_or
+#include <app/name_of_type.h>       // for name_of_type
+#include <third-party/nanobench.h>  // for Rng
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <algorithm>     // for max
+#include <array>         // for array
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <functional>    // for equal_to
+#include <memory>        // for allocator
+#include <string>        // for string
+#include <string_view>   // for string_view
+#include <type_traits>   // for false_type, true_type, void_t
+#include <unordered_map> // for unordered_map
+#include <utility>       // for pair, move
+#include <vector>        // for vector
+
+// Measures how much memory the maps need while inserting, rehashing, replacing, copying and erasing. Peak bytes are
+// what the process needs at least, also in the short moment where a rehash holds the old and the new buckets. Number of
+// elements is BENCH_MEMORY_SIZE, default 1000000.
+
+namespace {
+
+class allocation_stats {
+    struct per_type {
+        std::string_view m_type;
+        size_t m_num_allocs;
+        size_t m_bytes;
+    };
+
+    size_t m_current = 0;
+    size_t m_peak = 0;
+    size_t m_num_allocs = 0;
+    size_t m_num_deallocs = 0;
+    std::array<size_t, 64> m_size_histogram{}; // [i]: number of allocations with 2^i to 2^(i+1)-1 bytes
+    std::vector<per_type> m_types{};
+
+public:
+    void allocate(std::string_view type, size_t bytes) {
+        m_current += bytes;
+        m_peak = std::max(m_peak, m_current);
+        ++m_num_allocs;
+        size_t bin = 0;
+        while ((bytes >> (bin + 1)) != 0) {
+            ++bin;
+        }
+        ++m_size_histogram[bin];
+
+        auto it = std::find_if(m_types.begin(), m_types.end(), [&](per_type const& t) {
+            return t.m_type == type;
+        });
+        if (it == m_types.end()) {
+            m_types.push_back({type, 1, bytes});
+        } else {
+            ++it->m_num_allocs;
+            it->m_bytes += bytes;
+        }
+    }
+
+    void deallocate(size_t bytes) {
+        m_current -= bytes;
+        ++m_num_deallocs;
+    }
+
+    // counts only what happens from now on, except for the current bytes
+    void start_phase() {
+        m_peak = m_current;
+        m_num_allocs = 0;
+        m_num_deallocs = 0;
+        m_size_histogram = {};
+        m_types.clear();
+    }
+
+    void print(std::string_view map_name, std::string_view phase, size_t num_elements) const {
+        auto const n = static_cast<double>(num_elements);
+        fmt::print("| {:>11.2f} | {:>10.2f} | {:>7} | {:>7} | {} {}\n",
+                   static_cast<double>(m_peak) / n,
+                   static_cast<double>(m_current) / n,
+                   m_num_allocs,
+                   m_num_deallocs,
+                   map_name,
+                   phase);
+        for (auto const& t : m_types) {
+            fmt::print("|             |            |         |         |     {} allocations, {} bytes: {}\n",
+                       t.m_num_allocs,
+                       t.m_bytes,
+                       t.m_type);
+        }
+        auto sizes = std::string();
+        for (size_t bin = 0; bin < m_size_histogram.size(); ++bin) {
+            if (0 != m_size_histogram[bin]) {
+                sizes += fmt::format(" 2^{}:{}", bin, m_size_histogram[bin]);
+            }
+        }
+        if (!sizes.empty()) {
+            fmt::print("|             |            |         |         |     allocation sizes{}\n", sizes);
+        }
+    }
+};
+
+// Allocator that records everything in allocation_stats. The map rebinds it for its buckets, so they are tracked too.
+template <typename T>
+class tracking_allocator {
+    template <typename U>
+    friend class tracking_allocator;
+
+    allocation_stats* m_stats;
+
+public:
+    using value_type = T;
+
+    explicit tracking_allocator(allocation_stats* stats) noexcept
+        : m_stats(stats) {}
+
+    template <typename U>
+    tracking_allocator(tracking_allocator<U> const& other) noexcept // NOLINT(google-explicit-constructor)
+        : m_stats(other.m_stats) {}
+
+    auto allocate(size_t n) -> T* {
+        m_stats->allocate(name_of_type<T>(), n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        m_stats->deallocate(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    auto operator==(tracking_allocator<U> const& other) const noexcept -> bool {
+        return m_stats == other.m_stats;
+    }
+
+    template <typename U>
+    auto operator!=(tracking_allocator<U> const& other) const noexcept -> bool {
+        return m_stats != other.m_stats;
+    }
+};
+
+template <typename Map, typename = void>
+struct has_allocator : std::false_type {};
+
+template <typename Map>
+struct has_allocator<Map, std::void_t<typename Map::allocator_type>> : std::true_type {};
+
+template <typename Map, typename = void>
+struct has_value_container : std::false_type {};
+
+template <typename Map>
+struct has_value_container<Map, std::void_t<typename Map::value_container_type>> : std::true_type {};
+
+template <typename Map>
+[[nodiscard]] auto make_map(allocation_stats& stats) -> Map {
+    if constexpr (has_allocator<Map>::value) {
+        return Map(typename Map::allocator_type(&stats));
+    } else {
+        return Map();
+    }
+}
+
+// robin_hood::unordered_flat_map has no allocator, it mallocs a single block. Its size is calculated with its public
+// API, and a change is recorded like the map does it: allocate the new block, then free the old one.
+template <typename Map>
+void sync_untracked(Map const& map, size_t& tracked_bytes, allocation_stats& stats) {
+    if constexpr (!has_allocator<Map>::value) {
+        auto bytes = size_t();
+        if (0 != map.mask()) {
+            bytes = map.calcNumBytesTotal(map.calcNumElementsWithBuffer(map.mask() + 1));
+        }
+        if (bytes != tracked_bytes) {
+            if (0 != bytes) {
+                stats.allocate("robin_hood node array", bytes);
+            }
+            if (0 != tracked_bytes) {
+                stats.deallocate(tracked_bytes);
+            }
+            tracked_bytes = bytes;
+        }
+    }
+}
+
+[[nodiscard]] auto num_elements() -> size_t {
+    return env_or("BENCH_MEMORY_SIZE", 1000000);
+}
+
+template <typename Map>
+void bench(std::string_view name) {
+    auto const n = num_elements();
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<uint64_t>(n);
+    for (auto& key : keys) {
+        key = rng();
+    }
+
+    auto stats = allocation_stats();
+    auto map = make_map<Map>(stats);
+    auto map_bytes = size_t(); // only for maps without allocator
+
+    stats.start_phase();
+    for (auto key : keys) {
+        map.try_emplace(key, key);
+        sync_untracked(map, map_bytes, stats);
+    }
+    stats.print(name, "insert", n);
+
+    stats.start_phase();
+    map.rehash(2 * n);
+    sync_untracked(map, map_bytes, stats);
+    stats.print(name, "rehash", n);
+
+    // ankerl::unordered_dense::map can replace its values, the others have to build a new map and move it in
+    stats.start_phase();
+    if constexpr (has_value_container<Map>::value) {
+        auto values = map.values();
+        map.replace(std::move(values));
+    } else {
+        auto fresh = make_map<Map>(stats);
+        auto fresh_bytes = size_t();
+        for (auto const& kv : map) {
+            fresh.try_emplace(kv.first, kv.second);
+            sync_untracked(fresh, fresh_bytes, stats);
+        }
+        map = std::move(fresh);
+        if constexpr (!has_allocator<Map>::value) {
+            stats.deallocate(map_bytes);
+            map_bytes = fresh_bytes;
+        }
+    }
+    stats.print(name, "replace", n);
+
+    stats.start_phase();
+    {
+        auto copy = map;
+        auto copy_bytes = size_t();
+        sync_untracked(copy, copy_bytes, stats);
+        REQUIRE(copy.size() == n);
+        stats.print(name, "copy", n);
+        if constexpr (!has_allocator<Map>::value) {
+            stats.deallocate(copy_bytes);
+        }
+    }
+
+    stats.start_phase();
+    for (auto key : keys) {
+        map.erase(key);
+        sync_untracked(map, map_bytes, stats);
+    }
+    REQUIRE(map.empty());
+    stats.print(name, "erase", n);
+}
+
+template <typename Key, typename T>
+using tracked_map = ankerl::unordered_dense::map<Key,
+                                                 T,
+                                                 ankerl::unordered_dense::hash<Key>,
+                                                 std::equal_to<Key>,
+                                                 tracking_allocator<std::pair<Key, T>>>;
+
+template <typename Key, typename T>
+using tracked_big_map = ankerl::unordered_dense::map<Key,
+                                                     T,
+                                                     ankerl::unordered_dense::hash<Key>,
+                                                     std::equal_to<Key>,
+                                                     tracking_allocator<std::pair<Key, T>>,
+                                                     ankerl::unordered_dense::bucket_type::big>;
+
+template <typename Key, typename T>
+using tracked_std_map = std::unordered_map<Key,
+                                           T,
+                                           ankerl::unordered_dense::hash<Key>,
+                                           std::equal_to<Key>,
+                                           tracking_allocator<std::pair<Key const, T>>>;
+
+} // namespace
+
+TEST_CASE("bench_memory" * doctest::test_suite("bench") * doctest::skip()) {
+    fmt::print("| peak B/elem | end B/elem |  allocs |   frees | map phase\n");
+    fmt::print("|------------:|-----------:|--------:|--------:|:----------\n");
+    bench<tracked_map<uint64_t, uint64_t>>("ankerl::unordered_dense::map");
+    bench<tracked_big_map<uint64_t, uint64_t>>("ankerl::unordered_dense::map bucket_type::big");
+    bench<robin_hood::unordered_flat_map<uint64_t, uint64_t>>("robin_hood::unordered_flat_map");
+    bench<tracked_std_map<uint64_t, uint64_t>>("std::unordered_map");
+}
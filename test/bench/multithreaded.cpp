@@ -0,0 +1,210 @@
+#include <ankerl/unordered_dense.h> // for map
+
+#include <app/env_or.h>             // for env_or
+#include <third-party/nanobench.h>  // for Rng, doNotOptimizeAway
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <algorithm>     // for max
+#include <atomic>        // for atomic
+#include <chrono>        // for steady_clock, duration
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <string>        // for string
+#include <string_view>   // for string_view
+#include <thread>        // for thread, hardware_concurrency
+#include <unordered_map> // for unordered_map
+#include <utility>       // for move
+#include <vector>        // for vector
+
+// Throughput of 1 to N threads, where N is std::thread::hardware_concurrency() or BENCH_MT_THREADS. Each thread works
+// on BENCH_MT_SIZE elements, default 1000000. Scaling below 1.0x per thread shows allocator contention, memory bandwidth
+// limits, false sharing or NUMA effects.
+
+namespace {
+
+// 1, 2, 4, ... and max_threads
+[[nodiscard]] auto thread_counts(size_t max_threads) -> std::vector<size_t> {
+    auto counts = std::vector<size_t>();
+    for (size_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+        counts.push_back(num_threads);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// each thread writes its result into its own cache line
+struct alignas(64) thread_result {
+    uint64_t m_checksum = 0;
+};
+
+// Each thread's map in its own cache line. The map object changes with every insert, maps next to each other would cause
+// false sharing that the benchmark creates, not the map.
+template <typename Map>
+struct alignas(64) thread_map {
+    Map m_map{};
+};
+
+[[nodiscard]] auto make_keys(size_t n, uint64_t seed) -> std::vector<uint64_t> {
+    auto rng = ankerl::nanobench::Rng(seed);
+    auto keys = std::vector<uint64_t>(n);
+    for (auto& key : keys) {
+        key = rng();
+    }
+    return keys;
+}
+
+// Runs op(thread_idx) on num_threads threads that all start at the same time, returns the wall clock time in seconds.
+template <typename Op>
+[[nodiscard]] auto run_threads(size_t num_threads, Op op) -> double {
+    auto num_ready = std::atomic<size_t>(0);
+    auto go = std::atomic<bool>(false);
+    auto threads = std::vector<std::thread>();
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            ++num_ready;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            op(t);
+        });
+    }
+    while (num_ready.load() != num_threads) {
+        std::this_thread::yield();
+    }
+    auto const begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+class scaling_table {
+    std::string m_name;
+    double m_single_thread_ops_per_sec = 0.0;
+
+public:
+    explicit scaling_table(std::string name)
+        : m_name(std::move(name)) {}
+
+    void add(size_t num_threads, size_t total_ops, double seconds) {
+        auto const ops_per_sec = static_cast<double>(total_ops) / seconds;
+        if (1 == num_threads) {
+            m_single_thread_ops_per_sec = ops_per_sec;
+        }
+        auto const speedup = ops_per_sec / m_single_thread_ops_per_sec;
+        fmt::print("| {:>7} | {:>12.2f} | {:>7.2f}x | {:>9.0f}% | {}\n",
+                   num_threads,
+                   ops_per_sec / 1e6,
+                   speedup,
+                   100.0 * speedup / static_cast<double>(num_threads),
+                   m_name);
+    }
+};
+
+// Each thread builds and destroys its own map. All threads allocate at the same time, buckets and the values vector grow
+// concurrently.
+template <typename Map>
+void bench_per_thread_maps(std::string_view name, size_t max_threads, size_t n) {
+    auto table = scaling_table(fmt::format("{} per-thread insert", name));
+    auto keys = make_keys(n, 123);
+    for (auto num_threads : thread_counts(max_threads)) {
+        auto results = std::vector<thread_result>(num_threads);
+        auto const seconds = run_threads(num_threads, [&](size_t t) {
+            auto map = Map();
+            for (auto key : keys) {
+                map.try_emplace(key + t, key);
+            }
+            results[t].m_checksum = map.size();
+        });
+        for (auto const& r : results) {
+            REQUIRE(r.m_checksum == n);
+        }
+        table.add(num_threads, num_threads * n, seconds);
+    }
+}
+
+// All threads look up random keys in one shared map. There are no writes, so this is limited by memory bandwidth and
+// latency only.
+template <typename Map>
+void bench_shared_find(std::string_view name, size_t max_threads, size_t n) {
+    auto table = scaling_table(fmt::format("{} shared find", name));
+    auto const keys = make_keys(n, 123);
+    auto map = Map();
+    for (auto key : keys) {
+        map.try_emplace(key, key);
+    }
+    auto const& shared = map;
+
+    for (auto num_threads : thread_counts(max_threads)) {
+        auto results = std::vector<thread_result>(num_threads);
+        auto const seconds = run_threads(num_threads, [&](size_t t) {
+            auto rng = ankerl::nanobench::Rng(t);
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += shared.find(keys[rng.bounded(static_cast<uint32_t>(n))])->second;
+            }
+            results[t].m_checksum = sum;
+        });
+        for (auto const& r : results) {
+            ankerl::nanobench::doNotOptimizeAway(r.m_checksum);
+        }
+        table.add(num_threads, num_threads * n, seconds);
+    }
+}
+
+// Each thread builds a map, then all threads read from the maps of all other threads. On NUMA machines the memory of a
+// map is close to the thread that built it. Build and read are reported separately.
+template <typename Map>
+void bench_build_then_read(std::string_view name, size_t max_threads, size_t n) {
+    auto build_table = scaling_table(fmt::format("{} build", name));
+    auto read_table = scaling_table(fmt::format("{} read from all", name));
+    auto const keys = make_keys(n, 123);
+    for (auto num_threads : thread_counts(max_threads)) {
+        auto maps = std::vector<thread_map<Map>>(num_threads);
+        auto const build_seconds = run_threads(num_threads, [&](size_t t) {
+            for (auto key : keys) {
+                maps[t].m_map.try_emplace(key, key);
+            }
+        });
+        build_table.add(num_threads, num_threads * n, build_seconds);
+
+        auto results = std::vector<thread_result>(num_threads);
+        auto const read_seconds = run_threads(num_threads, [&](size_t t) {
+            auto rng = ankerl::nanobench::Rng(t);
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto const& map = maps[(t + i) % num_threads].m_map;
+                sum += map.find(keys[rng.bounded(static_cast<uint32_t>(n))])->second;
+            }
+            results[t].m_checksum = sum;
+        });
+        for (auto const& r : results) {
+            ankerl::nanobench::doNotOptimizeAway(r.m_checksum);
+        }
+        read_table.add(num_threads, num_threads * n, read_seconds);
+    }
+}
+
+template <typename Map>
+void bench_all(std::string_view name, size_t max_threads, size_t n) {
+    bench_per_thread_maps<Map>(name, max_threads, n);
+    bench_shared_find<Map>(name, max_threads, n);
+    bench_build_then_read<Map>(name, max_threads, n);
+}
+
+} // namespace
+
+TEST_CASE("bench_multithreaded" * doctest::test_suite("bench") * doctest::skip()) {
+    auto const max_threads = env_or("BENCH_MT_THREADS", std::max(size_t{1}, size_t{std::thread::hardware_concurrency()}));
+    auto const n = env_or("BENCH_MT_SIZE", 1000000);
+
+    fmt::print("| threads | Mops/s total |  speedup | efficiency | benchmark\n");
+    fmt::print("|--------:|-------------:|---------:|-----------:|:----------\n");
+    bench_all<ankerl::unordered_dense::map<uint64_t, uint64_t>>("ankerl::unordered_dense::map", max_threads, n);
+    bench_all<robin_hood::unordered_flat_map<uint64_t, uint64_t>>("robin_hood::unordered_flat_map", max_threads, n);
+    bench_all<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", max_threads, n);
+}
@@ -0,0 +1,66 @@
+#include <ankerl/unordered_dense.h> // for map, small_key
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format
+
+#include <cstddef>     // for size_t
+#include <functional>  // for equal_to
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace {
+
+constexpr size_t num_keys = 100000;
+
+// identifier like keys of 8 to 23 characters
+auto make_keys() -> std::vector<std::string> {
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<std::string>();
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto& key = keys.emplace_back(8 + rng.bounded(16), 'x');
+        for (auto& c : key) {
+            c = static_cast<char>('a' + rng.bounded(26));
+        }
+    }
+    return keys;
+}
+
+template <typename Map, typename ToKey>
+void bench(std::string_view name, std::vector<std::string> const& strs, ToKey to_key) {
+    auto keys = std::vector<typename Map::key_type>();
+    for (auto const& str : strs) {
+        keys.push_back(to_key(str));
+    }
+    auto map = Map();
+    for (auto const& key : keys) {
+        map[key] = map.size();
+    }
+    ankerl::nanobench::Bench().minEpochIterations(5).batch(keys.size()).run(fmt::format("find {}", name), [&] {
+        size_t sum = 0;
+        for (auto const& key : keys) {
+            sum += map.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+    ankerl::nanobench::Bench().minEpochIterations(5).batch(keys.size()).run(fmt::format("copy {}", name), [&] {
+        auto copy = map;
+        ankerl::nanobench::doNotOptimizeAway(copy);
+    });
+}
+
+} // namespace
+
+TEST_CASE("bench_small_key" * doctest::test_suite("bench") * doctest::skip()) {
+    using small_key_t = ankerl::unordered_dense::small_key<23>;
+    auto const strs = make_keys();
+    bench<ankerl::unordered_dense::map<std::string, size_t>>("map<std::string, size_t>", strs, [](std::string const& str) {
+        return str;
+    });
+    bench<ankerl::unordered_dense::map<small_key_t, size_t, ankerl::unordered_dense::hash<small_key_t>, std::equal_to<>>>(
+        "map<small_key<23>, size_t>", strs, [](std::string const& str) {
+            return small_key_t(str);
+        });
+}
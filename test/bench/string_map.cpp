@@ -0,0 +1,52 @@
+#include <ankerl/unordered_dense.h> // for map, string_map
+
+#include <third-party/nanobench.h> // for Rng, Bench, doNotOptimizeAway
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format
+
+#include <cstddef>     // for size_t
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace {
+
+constexpr size_t num_keys = 100000;
+
+// keys of 20 to 60 characters, so std::string can't use the small string optimization
+auto make_keys() -> std::vector<std::string> {
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<std::string>();
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto& key = keys.emplace_back(20 + rng.bounded(40), 'x');
+        for (auto& c : key) {
+            c = static_cast<char>('a' + rng.bounded(26));
+        }
+    }
+    return keys;
+}
+
+// builds the map, looks up every key, and destroys it again
+template <typename Map>
+void bench(std::string_view name, std::vector<std::string> const& keys) {
+    ankerl::nanobench::Bench().batch(num_keys).run(fmt::format("build & destroy {}", name), [&] {
+        auto map = Map();
+        for (auto const& key : keys) {
+            map[key] += 1;
+        }
+        size_t sum = 0;
+        for (auto const& key : keys) {
+            sum += map.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+} // namespace
+
+TEST_CASE("bench_string_map" * doctest::test_suite("bench") * doctest::skip()) {
+    auto const keys = make_keys();
+    bench<ankerl::unordered_dense::map<std::string, size_t>>("map<std::string, size_t>", keys);
+    bench<ankerl::unordered_dense::string_map<size_t>>("string_map<size_t>", keys);
+}
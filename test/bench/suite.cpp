@@ -0,0 +1,300 @@
+#include <ankerl/unordered_dense.h> // for map, hash
+
+#include <app/env_or.h>             // for env_or
+#include <third-party/nanobench.h>  // for Bench, Rng, doNotOptimizeAway, render
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <algorithm>     // for max
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t, uint32_t
+#include <cstdlib>       // for getenv
+#include <cstring>       // for memcpy
+#include <fstream>       // for ofstream
+#include <functional>    // for equal_to
+#include <memory>        // for allocator
+#include <string>        // for string
+#include <string_view>   // for string_view
+#include <type_traits>   // for conditional_t, is_same_v
+#include <unordered_map> // for unordered_map
+#include <utility>       // for pair, move
+#include <vector>        // for vector
+
+// Runs every map under test with every key type, size and operation. Results are printed and written as nanobench JSON
+// and CSV, each benchmark is named "map/key/size/operation". Configured with environment variables:
+//
+// BENCH_SUITE_MAX_SIZE: largest number of elements, sizes are 100, 1000, ... up to this. Default 1000000, up to 1e8 works
+//                       but needs lots of memory and time.
+// BENCH_SUITE_FILTER:   only run the maps and key types where "map/key" contains this string, e.g. "udm/" or "/u64".
+// BENCH_SUITE_OUT:      output files are <BENCH_SUITE_OUT>.json and <BENCH_SUITE_OUT>.csv. Default "bench_suite".
+//
+// All maps use the same hash so that the table designs are compared, not their default hashes.
+
+namespace {
+
+struct key16 {
+    uint64_t m_a;
+    uint64_t m_b;
+
+    auto operator==(key16 const& other) const noexcept -> bool {
+        return m_a == other.m_a && m_b == other.m_b;
+    }
+};
+
+struct key16_hash {
+    using is_avalanching = void;
+
+    auto operator()(key16 const& key) const noexcept -> uint64_t {
+        return ankerl::unordered_dense::detail::wyhash::hash(&key, sizeof(key));
+    }
+};
+
+// short strings fit into std::string's small buffer, long strings don't
+struct short_string_tag {};
+struct long_string_tag {};
+
+template <typename KeyKind>
+using key_of = std::conditional_t<std::is_same_v<KeyKind, short_string_tag> || std::is_same_v<KeyKind, long_string_tag>,
+                                  std::string,
+                                  KeyKind>;
+
+template <typename Key>
+using hash_of = std::conditional_t<std::is_same_v<Key, key16>, key16_hash, ankerl::unordered_dense::hash<Key>>;
+
+// Bijective, so key number i is unique
+[[nodiscard]] auto scramble(uint64_t i) -> uint64_t {
+    return i * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+template <typename KeyKind>
+[[nodiscard]] auto make_key(uint64_t i) -> key_of<KeyKind> {
+    auto const x = scramble(i);
+    if constexpr (std::is_same_v<KeyKind, uint32_t>) {
+        return static_cast<uint32_t>(i) * UINT32_C(0x9E3779B1);
+    } else if constexpr (std::is_same_v<KeyKind, uint64_t>) {
+        return x;
+    } else if constexpr (std::is_same_v<KeyKind, key16>) {
+        return key16{x, ~i};
+    } else if constexpr (std::is_same_v<KeyKind, short_string_tag>) {
+        auto str = std::string(8, '\0');
+        std::memcpy(str.data(), &x, sizeof(x));
+        return str;
+    } else {
+        // the varying bytes are at the end, so comparing two keys has to look at all of it
+        auto str = std::string(100, 'x');
+        std::memcpy(str.data() + str.size() - sizeof(x), &x, sizeof(x));
+        return str;
+    }
+}
+
+template <typename KeyKind>
+[[nodiscard]] auto make_keys(uint64_t begin, uint64_t end) -> std::vector<key_of<KeyKind>> {
+    auto keys = std::vector<key_of<KeyKind>>();
+    keys.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+        keys.push_back(make_key<KeyKind>(i));
+    }
+    return keys;
+}
+
+template <typename Key>
+using udm_map = ankerl::unordered_dense::map<Key, uint64_t, hash_of<Key>>;
+
+template <typename Key>
+using udm_big_map = ankerl::unordered_dense::map<Key,
+                                                 uint64_t,
+                                                 hash_of<Key>,
+                                                 std::equal_to<Key>,
+                                                 std::allocator<std::pair<Key, uint64_t>>,
+                                                 ankerl::unordered_dense::bucket_type::big>;
+
+template <typename Key>
+using robin_hood_map = robin_hood::unordered_flat_map<Key, uint64_t, hash_of<Key>>;
+
+template <typename Key>
+using std_map = std::unordered_map<Key, uint64_t, hash_of<Key>>;
+
+auto env(char const* varname) -> std::string {
+    auto const* value = std::getenv(varname); // NOLINT(concurrency-mt-unsafe)
+    return nullptr == value ? std::string() : std::string(value);
+}
+
+// Operations that modify the map get a fresh map for each iteration, prepared before the measurement: the pool has
+// exactly as many maps as nanobench runs iterations.
+template <typename Map, typename Make, typename Op>
+void run_pooled(ankerl::nanobench::Bench& bench, std::string const& name, size_t n, Make make, Op op) {
+    auto const epochs = n >= 1000000 ? size_t{3} : size_t{11};
+    auto const iters = std::max(size_t{1}, size_t{10000} / n);
+
+    auto pool = std::vector<Map>();
+    pool.reserve(epochs * iters);
+    for (size_t i = 0; i < epochs * iters; ++i) {
+        pool.push_back(make());
+    }
+
+    auto const old_epochs = bench.epochs();
+    size_t idx = 0;
+    bench.epochs(epochs).epochIterations(iters).run(name, [&] {
+        op(pool.at(idx++));
+    });
+    bench.epochs(old_epochs).epochIterations(0);
+    REQUIRE(idx == pool.size());
+}
+
+template <typename Map, typename KeyKind>
+void bench_size(ankerl::nanobench::Bench& bench, std::string_view prefix, size_t n) {
+    auto const keys = make_keys<KeyKind>(0, n);
+    auto const missing = make_keys<KeyKind>(n, 2 * n);
+    auto lookup = keys;
+    ankerl::nanobench::Rng(123).shuffle(lookup);
+
+    auto name = [&](std::string_view op) {
+        return fmt::format("{}/{}/{}", prefix, n, op);
+    };
+
+    auto const filled = [&] {
+        auto map = Map();
+        for (size_t i = 0; i < n; ++i) {
+            map.emplace(keys[i], i);
+        }
+        return map;
+    }();
+    REQUIRE(filled.size() == n);
+
+    bench.batch(n);
+
+    run_pooled<Map>(
+        bench,
+        name("insert"),
+        n,
+        [] {
+            return Map();
+        },
+        [&](Map& map) {
+            for (size_t i = 0; i < n; ++i) {
+                map.emplace(keys[i], i);
+            }
+        });
+
+    run_pooled<Map>(
+        bench,
+        name("reserve_insert"),
+        n,
+        [] {
+            return Map();
+        },
+        [&](Map& map) {
+            map.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                map.emplace(keys[i], i);
+            }
+        });
+
+    bench.run(name("find_hit"), [&] {
+        uint64_t sum = 0;
+        for (auto const& key : lookup) {
+            sum += filled.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+
+    bench.run(name("find_miss"), [&] {
+        size_t found = 0;
+        for (auto const& key : missing) {
+            found += static_cast<size_t>(filled.find(key) != filled.end());
+        }
+        ankerl::nanobench::doNotOptimizeAway(found);
+    });
+
+    run_pooled<Map>(
+        bench,
+        name("erase"),
+        n,
+        [&] {
+            return filled;
+        },
+        [&](Map& map) {
+            for (auto const& key : lookup) {
+                map.erase(key);
+            }
+        });
+
+    bench.run(name("iterate"), [&] {
+        uint64_t sum = 0;
+        for (auto const& kv : filled) {
+            sum += kv.second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+
+    run_pooled<Map>(
+        bench,
+        name("copy"),
+        n,
+        [] {
+            return Map();
+        },
+        [&](Map& map) {
+            map = filled;
+        });
+
+    run_pooled<Map>(
+        bench,
+        name("destroy"),
+        n,
+        [&] {
+            return filled;
+        },
+        [](Map& map) {
+            auto tmp = std::move(map);
+        });
+}
+
+template <template <typename> class MapOf, typename KeyKind>
+void bench_map(ankerl::nanobench::Bench& bench,
+               std::string_view map_name,
+               std::string_view key_name,
+               std::string const& filter,
+               size_t max_size) {
+    auto const prefix = fmt::format("{}/{}", map_name, key_name);
+    if (prefix.find(filter) == std::string::npos) {
+        return;
+    }
+    for (size_t n = 100; n <= max_size; n *= 10) {
+        bench_size<MapOf<key_of<KeyKind>>, KeyKind>(bench, prefix, n);
+    }
+}
+
+template <template <typename> class MapOf>
+void bench_keys(ankerl::nanobench::Bench& bench, std::string_view map_name, std::string const& filter, size_t max_size) {
+    bench_map<MapOf, uint32_t>(bench, map_name, "u32", filter, max_size);
+    bench_map<MapOf, uint64_t>(bench, map_name, "u64", filter, max_size);
+    bench_map<MapOf, key16>(bench, map_name, "key16", filter, max_size);
+    bench_map<MapOf, short_string_tag>(bench, map_name, "str8", filter, max_size);
+    bench_map<MapOf, long_string_tag>(bench, map_name, "str100", filter, max_size);
+}
+
+} // namespace
+
+TEST_CASE("bench_suite" * doctest::test_suite("bench") * doctest::skip()) {
+    auto const max_size = env_or("BENCH_SUITE_MAX_SIZE", 1000000);
+    auto const filter = env("BENCH_SUITE_FILTER");
+    auto out = env("BENCH_SUITE_OUT");
+    if (out.empty()) {
+        out = "bench_suite";
+    }
+
+    auto bench = ankerl::nanobench::Bench().title("suite").unit("op");
+    bench_keys<udm_map>(bench, "udm", filter, max_size);
+    bench_keys<udm_big_map>(bench, "udm_big", filter, max_size);
+    bench_keys<robin_hood_map>(bench, "robin_hood", filter, max_size);
+    bench_keys<std_map>(bench, "std", filter, max_size);
+
+    auto json = std::ofstream(out + ".json");
+    bench.render(ankerl::nanobench::templates::json(), json);
+    auto csv = std::ofstream(out + ".csv");
+    bench.render(ankerl::nanobench::templates::csv(), csv);
+    fmt::print("{} results written to {}.json and {}.csv\n", bench.results().size(), out, out);
+}
@@ -0,0 +1,179 @@
+#include <ankerl/unordered_dense.h> // for map
+
+#include <app/env_or.h>             // for env_or
+#include <app/zipf.h>               // for zipf_distribution
+#include <third-party/nanobench.h>  // for Bench, Rng, doNotOptimizeAway
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format, print
+
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <cstdlib>       // for getenv
+#include <filesystem>    // for directory_iterator, path
+#include <fstream>       // for ifstream
+#include <optional>      // for optional, nullopt
+#include <sstream>       // for istringstream
+#include <stdexcept>     // for runtime_error
+#include <string>        // for string, getline
+#include <string_view>   // for string_view
+#include <unordered_map> // for unordered_map
+#include <utility>       // for move
+#include <vector>        // for vector
+
+// Replays key traces recorded in production. All files in BENCH_TRACE_DIR are replayed (meson sets it to data/trace),
+// put your own traces there. Before them, a generated Zipf trace (s = 0.99) with BENCH_TRACE_SIZE operations (default
+// 1000000) is replayed: 75% get, 20% set and 5% del on 100000 keys "user:N". A trace is a text file with one operation per
+// line:
+//
+//     get <key>   find the key
+//     set <key>   insert the key, or update its value
+//     del <key>   erase the key
+//     <key>       same as get
+//
+// Keys are arbitrary strings without whitespace. Empty lines and lines starting with # are ignored.
+
+namespace {
+
+enum class trace_op : uint8_t { get, set, del };
+
+struct trace_entry {
+    trace_op m_op;
+    std::string m_key;
+};
+
+[[nodiscard]] auto parse_line(std::string const& line) -> std::optional<trace_entry> {
+    auto in = std::istringstream(line);
+    auto first = std::string();
+    if (!(in >> first) || first[0] == '#') {
+        return std::nullopt;
+    }
+    auto key = std::string();
+    if (!(in >> key)) {
+        return trace_entry{trace_op::get, first};
+    }
+    if (first == "get") {
+        return trace_entry{trace_op::get, key};
+    }
+    if (first == "set") {
+        return trace_entry{trace_op::set, key};
+    }
+    if (first == "del") {
+        return trace_entry{trace_op::del, key};
+    }
+    throw std::runtime_error("unknown trace operation '" + first + "' in line '" + line + "'");
+}
+
+[[nodiscard]] auto load_trace(std::filesystem::path const& path) -> std::vector<trace_entry> {
+    auto f = std::ifstream(path);
+    if (!f) {
+        throw std::runtime_error("can't open trace " + path.string());
+    }
+    auto trace = std::vector<trace_entry>();
+    auto line = std::string();
+    while (std::getline(f, line)) {
+        if (auto entry = parse_line(line)) {
+            trace.push_back(std::move(*entry));
+        }
+    }
+    return trace;
+}
+
+[[nodiscard]] auto generate_trace(size_t num_ops) -> std::vector<trace_entry> {
+    static constexpr size_t num_keys = 100000;
+
+    auto const zipf = zipf_distribution(num_keys, 0.99);
+    auto rng = ankerl::nanobench::Rng(123);
+    // the hot keys are not the first ones that are inserted
+    auto ids = std::vector<size_t>(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        ids[i] = i;
+    }
+    rng.shuffle(ids);
+
+    auto trace = std::vector<trace_entry>(num_ops);
+    for (auto& entry : trace) {
+        auto const r = rng.bounded(100);
+        entry.m_op = r < 75 ? trace_op::get : r < 95 ? trace_op::set : trace_op::del;
+        entry.m_key = "user:" + std::to_string(ids[zipf(rng)]);
+    }
+    return trace;
+}
+
+// Starts with an empty map, so inserts and rehashes are part of the replay like in the recorded process
+template <typename Map>
+void replay(ankerl::nanobench::Bench& bench,
+            std::string_view name,
+            std::string_view trace_name,
+            std::vector<trace_entry> const& trace) {
+    bench.batch(trace.size()).run(fmt::format("{} {}", name, trace_name), [&] {
+        auto map = Map();
+        uint64_t value = 0;
+        uint64_t found = 0;
+        for (auto const& entry : trace) {
+            switch (entry.m_op) {
+            case trace_op::get:
+                found += static_cast<uint64_t>(map.find(entry.m_key) != map.end());
+                break;
+            case trace_op::set:
+                map[entry.m_key] = ++value;
+                break;
+            case trace_op::del:
+                map.erase(entry.m_key);
+                break;
+            }
+        }
+        ankerl::nanobench::doNotOptimizeAway(found);
+    });
+}
+
+void replay_all(ankerl::nanobench::Bench& bench, std::string_view trace_name, std::vector<trace_entry> const& trace) {
+    replay<ankerl::unordered_dense::map<std::string, uint64_t>>(bench, "ankerl::unordered_dense::map", trace_name, trace);
+    replay<robin_hood::unordered_flat_map<std::string, uint64_t>>(bench, "robin_hood::unordered_flat_map", trace_name, trace);
+    replay<std::unordered_map<std::string, uint64_t>>(bench, "std::unordered_map", trace_name, trace);
+}
+
+} // namespace
+
+TEST_CASE("bench_trace" * doctest::test_suite("bench") * doctest::skip()) {
+    auto const* dir = std::getenv("BENCH_TRACE_DIR"); // NOLINT(concurrency-mt-unsafe)
+    if (nullptr == dir) {
+        throw std::runtime_error("Environment variable BENCH_TRACE_DIR not set!");
+    }
+    auto const num_ops = env_or("BENCH_TRACE_SIZE", 1000000);
+
+    auto bench = ankerl::nanobench::Bench().title("trace").unit("op");
+    replay_all(bench, "generated zipf", generate_trace(num_ops));
+    size_t num_traces = 0;
+    for (auto const& dir_entry : std::filesystem::directory_iterator(dir)) {
+        auto const& path = dir_entry.path();
+        auto const trace = load_trace(path);
+        fmt::print("{}: {} operations\n", path.string(), trace.size());
+        replay_all(bench, path.filename().string(), trace);
+        ++num_traces;
+    }
+    REQUIRE(0U != num_traces);
+}
+
+TEST_CASE("trace_parse") {
+    REQUIRE(!parse_line("").has_value());
+    REQUIRE(!parse_line("   ").has_value());
+    REQUIRE(!parse_line("# comment").has_value());
+
+    auto entry = parse_line("user:123");
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->m_op == trace_op::get);
+    REQUIRE(entry->m_key == "user:123");
+
+    entry = parse_line("set user:42");
+    REQUIRE(entry->m_op == trace_op::set);
+    REQUIRE(entry->m_key == "user:42");
+
+    entry = parse_line("del x");
+    REQUIRE(entry->m_op == trace_op::del);
+    REQUIRE(entry->m_key == "x");
+
+    REQUIRE(parse_line("get y")->m_op == trace_op::get);
+    REQUIRE_THROWS_AS(parse_line("put y"), std::runtime_error);
+}
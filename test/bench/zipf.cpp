@@ -0,0 +1,113 @@
+#include <ankerl/unordered_dense.h> // for map
+
+#include <app/zipf.h>               // for zipf_distribution
+#include <third-party/nanobench.h>  // for Rng, Bench, doNotOptimizeAway
+#include <third-party/robin_hood.h> // for unordered_flat_map
+
+#include <doctest.h>  // for TestCase, skip, TEST_CASE, test_...
+#include <fmt/core.h> // for format
+
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <cstdlib>       // for getenv, strtod
+#include <string_view>   // for string_view
+#include <unordered_map> // for unordered_map
+#include <vector>        // for vector
+
+// Lookups and updates where a few hot keys get most of the traffic, like in production. Element i of the map is
+// accessed with probability proportional to 1 / (i + 1)^s. s = 0 is uniform, s = 1 is classic Zipf, larger is more
+// skewed. BENCH_ZIPF_S sets a single s, default runs 0, 0.8, 0.99 and 1.2.
+
+namespace {
+
+// The ranks are drawn before the measurement, so the distribution's cost isn't measured
+[[nodiscard]] auto draw_keys(std::vector<uint64_t> const& keys, double s, size_t num_draws) -> std::vector<uint64_t> {
+    auto const zipf = zipf_distribution(keys.size(), s);
+    auto rng = ankerl::nanobench::Rng(987);
+    auto drawn = std::vector<uint64_t>(num_draws);
+    for (auto& key : drawn) {
+        key = keys[zipf(rng)];
+    }
+    return drawn;
+}
+
+template <typename Map>
+void bench_skew(ankerl::nanobench::Bench& bench, std::string_view name, size_t n, double s) {
+    static constexpr size_t num_ops = 1000000;
+
+    auto rng = ankerl::nanobench::Rng(123);
+    auto keys = std::vector<uint64_t>(n);
+    for (auto& key : keys) {
+        key = rng();
+    }
+    auto const accessed = draw_keys(keys, s, num_ops);
+
+    // inserted in random order, so the hot keys are not next to each other in the map's memory
+    auto map = Map();
+    rng.shuffle(keys);
+    for (auto key : keys) {
+        map.try_emplace(key, key);
+    }
+
+    bench.batch(num_ops).run(fmt::format("{} n={} s={} find", name, n, s), [&] {
+        uint64_t sum = 0;
+        for (auto key : accessed) {
+            sum += map.find(key)->second;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+
+    bench.batch(num_ops).run(fmt::format("{} n={} s={} update", name, n, s), [&] {
+        for (auto key : accessed) {
+            ++map[key];
+        }
+    });
+}
+
+template <typename Map>
+void bench_sizes(ankerl::nanobench::Bench& bench, std::string_view name, std::vector<double> const& skews) {
+    // fits into the cache, and doesn't
+    for (auto n : {size_t{10000}, size_t{1000000}}) {
+        for (auto s : skews) {
+            bench_skew<Map>(bench, name, n, s);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("bench_zipf" * doctest::test_suite("bench") * doctest::skip()) {
+    auto skews = std::vector<double>{0.0, 0.8, 0.99, 1.2};
+    if (auto const* str = std::getenv("BENCH_ZIPF_S"); nullptr != str) { // NOLINT(concurrency-mt-unsafe)
+        skews = {std::strtod(str, nullptr)};
+    }
+
+    auto b = ankerl::nanobench::Bench().title("zipf").unit("op");
+    bench_sizes<ankerl::unordered_dense::map<uint64_t, uint64_t>>(b, "ankerl::unordered_dense::map", skews);
+    bench_sizes<robin_hood::unordered_flat_map<uint64_t, uint64_t>>(b, "robin_hood::unordered_flat_map", skews);
+    bench_sizes<std::unordered_map<uint64_t, uint64_t>>(b, "std::unordered_map", skews);
+}
+
+TEST_CASE("zipf_distribution") {
+    auto rng = ankerl::nanobench::Rng(123);
+    auto counts = std::vector<size_t>(100);
+
+    auto const uniform = zipf_distribution(100, 0.0);
+    for (size_t i = 0; i < 100000; ++i) {
+        ++counts[uniform(rng)];
+    }
+    for (auto c : counts) {
+        REQUIRE(c > 800);
+        REQUIRE(c < 1200);
+    }
+
+    counts.assign(100, 0);
+    auto const zipf = zipf_distribution(100, 1.0);
+    for (size_t i = 0; i < 100000; ++i) {
+        ++counts[zipf(rng)];
+    }
+    // rank 0 is twice as likely as rank 1, and 100 times as likely as rank 99
+    REQUIRE(counts[0] > counts[1] * 18 / 10);
+    REQUIRE(counts[0] < counts[1] * 22 / 10);
+    REQUIRE(counts[0] > counts[99] * 50);
+}
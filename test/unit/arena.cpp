@@ -0,0 +1,120 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/counter.h>
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t, uintptr_t
+#include <string>  // for string, to_string
+#include <utility> // for move
+
+TEST_CASE("arena") {
+    auto a = ankerl::unordered_dense::arena(64);
+    REQUIRE(a.capacity() == 0);
+
+    auto* p1 = a.allocate(10, 1);
+    auto* p2 = a.allocate(8, 8);
+    REQUIRE(reinterpret_cast<uintptr_t>(p2) % 8 == 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    REQUIRE(p1 != p2);
+    REQUIRE(a.capacity() == 64);
+
+    // freeing the most recent allocation makes its memory available again
+    auto const used = a.used();
+    a.deallocate(p2, 8);
+    REQUIRE(a.used() == used - 8);
+    REQUIRE(a.allocate(8, 8) == p2);
+    REQUIRE(a.used() == used);
+
+    // doesn't fit into the first block
+    auto* p3 = a.allocate(1000, 16);
+    REQUIRE(reinterpret_cast<uintptr_t>(p3) % 16 == 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    REQUIRE(a.capacity() > 1000);
+
+    // reset keeps the biggest block
+    auto capa = a.capacity();
+    a.reset();
+    REQUIRE(a.capacity() < capa);
+    REQUIRE(a.capacity() > 1000);
+    REQUIRE(a.allocate(1000, 16) == p3);
+
+    a.release();
+    REQUIRE(a.capacity() == 0);
+    REQUIRE(a.used() == 0);
+}
+
+TEST_CASE("arena_map_rehash_reuses_buckets") {
+    using map_t = ankerl::unordered_dense::arena_map<uint64_t, uint64_t>;
+    auto a = ankerl::unordered_dense::arena(size_t{1} << 24U); // big enough for all allocations
+    auto map = map_t(a);
+    size_t num_rehashes = 0;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        auto const old_num_buckets = map.bucket_count();
+        auto const old_used = a.used();
+        auto const old_capacity = a.capacity();
+        map.try_emplace(i, i);
+        if (0 == old_num_buckets) {
+            continue;
+        }
+        if (old_num_buckets == map.bucket_count()) {
+            // the values already have room for all elements the buckets can hold
+            REQUIRE(a.used() == old_used);
+        } else {
+            // the old buckets were the most recent allocation and are reused, only the old values are left behind
+            ++num_rehashes;
+            auto const old_bucket_bytes = old_num_buckets * sizeof(map_t::bucket_type);
+            auto const new_bytes =
+                map.bucket_count() * sizeof(map_t::bucket_type) + map.values().capacity() * sizeof(map_t::value_type);
+            REQUIRE(a.used() == old_used - old_bucket_bytes + new_bytes);
+            REQUIRE(a.capacity() == old_capacity);
+        }
+    }
+    REQUIRE(num_rehashes > 10);
+}
+
+TEST_CASE("arena_map") {
+    auto a = ankerl::unordered_dense::arena();
+    for (int round = 0; round < 3; ++round) {
+        {
+            auto map = ankerl::unordered_dense::arena_map<uint64_t, std::string>(a);
+            for (uint64_t i = 0; i < 1000; ++i) {
+                map.try_emplace(i, std::to_string(i));
+            }
+            REQUIRE(map.size() == 1000);
+            for (uint64_t i = 0; i < 1000; i += 2) {
+                REQUIRE(map.erase(i) == 1);
+            }
+            auto map2 = map;
+            REQUIRE(map2 == map);
+            REQUIRE(&map2.get_allocator().get_arena() == &a);
+
+            auto set = ankerl::unordered_dense::arena_set<uint64_t>(a);
+            for (auto const& [key, val] : map) {
+                REQUIRE(std::to_string(key) == val);
+                set.insert(key);
+            }
+            REQUIRE(set.size() == 500);
+            set.rehash(0);
+            REQUIRE(set.size() == 500);
+        }
+        a.reset();
+    }
+}
+
+TEST_CASE("arena_map_counter") {
+    auto counts = counter();
+    INFO(counts);
+
+    auto a = ankerl::unordered_dense::arena();
+    {
+        auto map = ankerl::unordered_dense::arena_map<counter::obj, counter::obj>(a);
+        for (size_t i = 0; i < 100; ++i) {
+            map.try_emplace(counter::obj(i, counts), i, counts);
+        }
+        auto map2 = std::move(map);
+        REQUIRE(map2.size() == 100);
+        map = map2;
+        REQUIRE(map.size() == 100);
+    }
+    REQUIRE(counts.ctor() + counts.default_ctor() + counts.copy_ctor() + counts.move_ctor() == counts.dtor());
+}
@@ -0,0 +1,108 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <cstdint>    // for uint64_t, uint32_t
+#include <functional> // for equal_to
+#include <memory>     // for allocator
+#include <utility>    // for move, pair
+
+using map_t = ankerl::unordered_dense::map<uint64_t, uint64_t>;
+
+namespace {
+
+// the recycler frees arrays without alignment, so it must never get these
+struct alignas(2 * __STDCPP_DEFAULT_NEW_ALIGNMENT__) over_aligned_bucket {
+    static constexpr uint32_t dist_inc = 1U << 8U;
+    static constexpr uint32_t fingerprint_mask = dist_inc - 1;
+
+    uint32_t m_dist_and_fingerprint;
+    uint32_t m_value_idx;
+};
+
+auto make_map(size_t num_elements) -> map_t {
+    auto map = map_t();
+    for (uint64_t i = 0; i < num_elements; ++i) {
+        map[i] = i;
+    }
+    return map;
+}
+
+} // namespace
+
+TEST_CASE("bucket_recycler") {
+    REQUIRE(ankerl::unordered_dense::bucket_recycler::current() == nullptr);
+    {
+        auto recycler = ankerl::unordered_dense::bucket_recycler();
+        REQUIRE(ankerl::unordered_dense::bucket_recycler::current() == &recycler);
+
+        // each rehash hands the old bucket array to the recycler
+        auto map = make_map(1000);
+        REQUIRE(recycler.size() > 0);
+        auto num_cached = recycler.size();
+
+        // the small arrays are reused by the next map
+        auto map2 = make_map(1000);
+        REQUIRE(recycler.size() == num_cached);
+        REQUIRE(map2 == map);
+
+        map = map_t();
+        REQUIRE(recycler.size() == num_cached + 1);
+        auto map3 = map2;
+        REQUIRE(recycler.size() == num_cached);
+        REQUIRE(map3 == map2);
+
+        {
+            // nested recycler is used instead
+            auto inner = ankerl::unordered_dense::bucket_recycler(1);
+            REQUIRE(ankerl::unordered_dense::bucket_recycler::current() == &inner);
+            auto m = make_map(100);
+            REQUIRE(inner.size() == 1);
+        }
+        REQUIRE(ankerl::unordered_dense::bucket_recycler::current() == &recycler);
+
+        // only the first array with 16 buckets is small enough to be cached
+        auto small = ankerl::unordered_dense::bucket_recycler(10, 16 * sizeof(ankerl::unordered_dense::bucket_type::standard));
+        auto m = make_map(100);
+        m.clear();
+        REQUIRE(small.size() == 1);
+    }
+    REQUIRE(ankerl::unordered_dense::bucket_recycler::current() == nullptr);
+}
+
+TEST_CASE("bucket_recycler_many_maps") {
+    auto recycler = ankerl::unordered_dense::bucket_recycler();
+    for (size_t round = 0; round < 100; ++round) {
+        auto map = make_map(round);
+        for (uint64_t i = 0; i < round; ++i) {
+            REQUIRE(map.at(i) == i);
+        }
+        auto moved = std::move(map);
+        REQUIRE(moved.size() == round);
+        moved.rehash(0);
+        REQUIRE(moved.size() == round);
+    }
+    REQUIRE(recycler.size() <= ankerl::unordered_dense::bucket_recycler::default_max_cached_arrays);
+}
+
+TEST_CASE("bucket_recycler_over_aligned") {
+    using over_aligned_map_t = ankerl::unordered_dense::map<uint64_t,
+                                                            uint64_t,
+                                                            ankerl::unordered_dense::hash<uint64_t>,
+                                                            std::equal_to<uint64_t>,
+                                                            std::allocator<std::pair<uint64_t, uint64_t>>,
+                                                            over_aligned_bucket>;
+
+    auto recycler = ankerl::unordered_dense::bucket_recycler();
+    auto map = over_aligned_map_t();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    map = over_aligned_map_t();
+    REQUIRE(recycler.size() == 0);
+
+    // normal maps still use the recycler
+    auto normal = make_map(1000);
+    REQUIRE(recycler.size() > 0);
+}
@@ -0,0 +1,212 @@
+// Counters change the layout of the table, so they get a different inline namespace and this translation unit can be linked
+// with all the others.
+#define ANKERL_UNORDERED_DENSE_STATS 1 // NOLINT(cppcoreguidelines-macro-usage)
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <random>      // for mt19937_64
+#include <thread>      // for thread
+#include <type_traits> // for is_same_v
+#include <utility>     // for move
+#include <vector>      // for vector
+
+static_assert(std::is_same_v<ankerl::unordered_dense::v3_0_2_stats::map<int, int>, ankerl::unordered_dense::map<int, int>>);
+
+namespace {
+
+// Keeps only the upper 8 bits of a good hash: the fingerprint is always 0, so keys with the same home bucket always need a
+// key comparison.
+struct hash_without_fingerprint {
+    using is_avalanching = void;
+
+    auto operator()(uint64_t key) const noexcept -> uint64_t {
+        return ankerl::unordered_dense::detail::wyhash::hash(key) & UINT64_C(0xFF00000000000000);
+    }
+};
+
+} // namespace
+
+TEST_CASE("counters") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    REQUIRE(map.counters().finds == 0);
+    REQUIRE(!map.contains(1));
+    REQUIRE(map.counters().finds == 1);
+    REQUIRE(map.counters().find_misses == 1);
+    REQUIRE(map.counters().probe_steps == 0);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    auto c = map.counters();
+    REQUIRE(c.rehashes > 0);
+    // all bucket arrays and all arrays of the values vector while it grew
+    REQUIRE(c.bytes_allocated >= map.bucket_count() * sizeof(decltype(map)::bucket_type) +
+                                     map.values().capacity() * sizeof(decltype(map)::value_type));
+
+    map.reset_counters();
+    for (uint64_t i = 0; i < 2000; ++i) {
+        REQUIRE(map.contains(i) == (i < 1000));
+    }
+    c = map.counters();
+    REQUIRE(c.finds == 2000);
+    REQUIRE(c.find_hits == 1000);
+    REQUIRE(c.find_misses == 1000);
+    REQUIRE(c.probe_steps >= 2000);
+    REQUIRE(c.key_compares >= 1000);
+    REQUIRE(c.key_compares == 1000 + c.fingerprint_false_positives);
+
+    // the probe steps of all hits are the sum of all probe lengths
+    map.reset_counters();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        REQUIRE(map.find(i) != map.end());
+    }
+    c = map.counters();
+    auto st = map.stats();
+    REQUIRE(static_cast<double>(c.probe_steps) == doctest::Approx(st.mean_probe_length * 1000.0));
+    REQUIRE(c.fingerprint_false_positives == st.fingerprint_collisions);
+
+    map.reset_counters();
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        REQUIRE(map.erase(i) == 1);
+    }
+    c = map.counters();
+    REQUIRE(c.erase_shifts > 0);
+    REQUIRE(c.rehashes == 0);
+
+    auto copy = map;
+    REQUIRE(copy.counters().finds == 0);
+    REQUIRE(copy.counters().bytes_allocated == copy.bucket_count() * sizeof(decltype(copy)::bucket_type) +
+                                                   copy.values().capacity() * sizeof(decltype(copy)::value_type));
+
+    // shrinking the values vector allocates a smaller one
+    map.reset_counters();
+    map.rehash(0);
+    REQUIRE(map.counters().rehashes == 1);
+    REQUIRE(map.counters().bytes_allocated == map.bucket_count() * sizeof(decltype(map)::bucket_type) +
+                                                  map.values().capacity() * sizeof(decltype(map)::value_type));
+}
+
+TEST_CASE("counters_values_growth") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    map.reserve(1000);
+    auto const bucket_bytes = map.bucket_count() * sizeof(decltype(map)::bucket_type);
+    auto const values_bytes = map.values().capacity() * sizeof(decltype(map)::value_type);
+    REQUIRE(map.counters().bytes_allocated == bucket_bytes + values_bytes);
+
+    // no allocation, neither buckets nor values need to grow
+    for (uint64_t i = 0; i < 500; ++i) {
+        map[i] = i;
+    }
+    REQUIRE(map.counters().bytes_allocated == bucket_bytes + values_bytes);
+}
+
+TEST_CASE("counters_false_positives") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t, hash_without_fingerprint>();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    REQUIRE(map.counters().shift_ups > 0);
+    map.reset_counters();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        REQUIRE(map.contains(i));
+    }
+    REQUIRE(map.counters().fingerprint_false_positives > 0);
+    REQUIRE(map.counters().fingerprint_false_positives == map.stats().fingerprint_collisions);
+}
+
+TEST_CASE("counters_assignment") {
+    auto source = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        source[i] = i;
+    }
+    auto const source_bytes = source.counters().bytes_allocated;
+
+    auto target = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    for (uint64_t i = 0; i < 100; ++i) {
+        target[i] = i;
+        REQUIRE(target.contains(i));
+    }
+    REQUIRE(target.counters().finds == 100);
+
+    // a copy assignment starts at 0, only the buckets and the grown values of the copy are counted
+    target = source;
+    REQUIRE(target.counters().finds == 0);
+    REQUIRE(target.counters().rehashes == 0);
+    REQUIRE(target.counters().bytes_allocated == target.bucket_count() * sizeof(decltype(target)::bucket_type) +
+                                                     target.values().capacity() * sizeof(decltype(target)::value_type));
+    REQUIRE(target.counters().bytes_allocated <= source_bytes);
+
+    // the values fit now, only the buckets are allocated again
+    target = source;
+    REQUIRE(target.counters().bytes_allocated == target.bucket_count() * sizeof(decltype(target)::bucket_type));
+
+    REQUIRE(target.contains(1));
+    REQUIRE(target.counters().finds == 1);
+
+    // a move assignment starts at 0 too
+    target = std::move(source);
+    REQUIRE(target.size() == 1000);
+    REQUIRE(target.counters().finds == 0);
+    REQUIRE(target.counters().rehashes == 0);
+    REQUIRE(target.counters().bytes_allocated == 0);
+}
+
+TEST_CASE("counters_concurrent_find") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    map.reset_counters();
+
+    // finds on a shared const map are fine, the counters are atomic. Concurrent updates can get lost, so the counts are
+    // only a lower bound.
+    auto const& shared = map;
+    auto threads = std::vector<std::thread>();
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (uint64_t i = 0; i < 2000; ++i) {
+                static_cast<void>(shared.contains(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto const c = map.counters();
+    REQUIRE(c.finds >= 2000);
+    REQUIRE(c.finds <= 4 * 2000);
+    REQUIRE(c.find_hits <= 4 * 1000);
+    REQUIRE(c.find_misses <= 4 * 1000);
+}
+
+TEST_CASE("counters_rehash_no_shift_ups") {
+    // random keys, sequential ones are spread so evenly that no buckets need to be moved
+    auto rng = std::mt19937_64(123);
+    auto keys = std::vector<uint64_t>(10000);
+    for (auto& key : keys) {
+        key = rng();
+    }
+
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    for (auto key : keys) {
+        map[key] = key;
+    }
+    map.reset_counters();
+    map.rehash(20000);
+    REQUIRE(map.counters().rehashes == 1);
+    REQUIRE(map.counters().shift_ups == 0);
+
+    // inserting the same keys at this bucket count moves buckets, those are counted
+    auto fresh = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    fresh.rehash(20000);
+    REQUIRE(fresh.bucket_count() == map.bucket_count());
+    fresh.reset_counters();
+    for (auto key : keys) {
+        fresh[key] = key;
+    }
+    REQUIRE(fresh.counters().rehashes == 0);
+    REQUIRE(fresh.counters().shift_ups > 0);
+}
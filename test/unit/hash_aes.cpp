@@ -0,0 +1,57 @@
+// test the AES-NI code, not just the portable fallback
+#define ANKERL_UNORDERED_DENSE_X86_DISPATCH // NOLINT(cppcoreguidelines-macro-usage)
+#include <ankerl/unordered_dense.h>
+
+#include <app/hash_checks.h> // for is_avalanching_hash_v
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <memory>      // for make_unique
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <type_traits> // for is_same_v
+
+static_assert(std::is_same_v<ankerl::unordered_dense::v3_0_2_x86::map<int, int>, ankerl::unordered_dense::map<int, int>>);
+
+static_assert(is_avalanching_hash_v<ankerl::unordered_dense::hash_aes<std::string>>);
+static_assert(is_avalanching_hash_v<ankerl::unordered_dense::hash_aes<std::string_view>>);
+static_assert(is_avalanching_hash_v<ankerl::unordered_dense::hash_aes<uint64_t>>); // same as hash<uint64_t>
+
+TEST_CASE("hash_aes") {
+    auto h = ankerl::unordered_dense::hash_aes<std::string_view>();
+    auto hs = ankerl::unordered_dense::hash_aes<std::string>();
+
+    auto str = std::string();
+    auto hashes = ankerl::unordered_dense::set<uint64_t>();
+    for (size_t len = 0; len < 300; ++len) {
+        // exactly sized heap buffer, so the address sanitizer finds out of bounds reads
+        auto buf = std::make_unique<char[]>(len); // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        for (size_t i = 0; i < len; ++i) {
+            buf[i] = static_cast<char>('a' + (i % 26));
+        }
+        auto sv = std::string_view(buf.get(), len);
+        REQUIRE(h(sv) == hs(std::string(sv)));
+        REQUIRE(hashes.insert(h(sv)).second);
+
+        // every single byte matters
+        for (size_t i = 0; i < len; ++i) {
+            auto before = h(sv);
+            ++buf[i];
+            REQUIRE(h(sv) != before);
+            --buf[i];
+            REQUIRE(h(sv) == before);
+        }
+    }
+
+    // trailing zeros are different from a shorter string
+    REQUIRE(h(std::string_view("a\0", 2)) != h(std::string_view("a", 1)));
+
+    auto map = ankerl::unordered_dense::map<std::string, size_t, ankerl::unordered_dense::hash_aes<std::string>>();
+    for (size_t i = 0; i < 1000; ++i) {
+        map[std::to_string(i) + "some suffix to make the key longer than 32 bytes"] = i;
+    }
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.at("123some suffix to make the key longer than 32 bytes") == 123);
+}
@@ -0,0 +1,76 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/hash_checks.h> // for is_avalanching_v, hash_of
+
+#include <doctest.h>
+
+#include <array>       // for array
+#include <cstdint>     // for uint32_t, uint64_t
+#include <type_traits> // for true_type
+#include <vector>      // for vector
+
+#if ANKERL_UNORDERED_DENSE_CPP_VERSION >= 202002L && defined(__cpp_lib_span)
+#    include <span> // for span
+#endif
+
+namespace {
+
+// packed 12 byte id
+struct id12 {
+    uint32_t a{};
+    uint32_t b{};
+    uint32_t c{};
+
+    auto operator==(id12 const& other) const -> bool {
+        return a == other.a && b == other.b && c == other.c;
+    }
+};
+
+enum class color : uint8_t { red, green, blue };
+
+} // namespace
+
+template <>
+struct ankerl::unordered_dense::is_bytewise_hashable<id12> : std::true_type {};
+
+static_assert(is_avalanching_v<id12>);
+static_assert(is_avalanching_v<std::vector<id12>>);
+static_assert(is_avalanching_v<std::vector<int>>);
+static_assert(is_avalanching_v<std::vector<color>>);
+static_assert(is_avalanching_v<std::vector<int const*>>);
+static_assert(ankerl::unordered_dense::is_bytewise_hashable_v<color>);
+static_assert(!ankerl::unordered_dense::is_bytewise_hashable_v<double>);
+
+TEST_CASE("hash_bytewise") {
+    auto const i = id12{1, 2, 3};
+    REQUIRE(hash_of(i) == ankerl::unordered_dense::detail::wyhash::hash(&i, sizeof(i)));
+    REQUIRE(hash_of(i) != hash_of(id12{3, 2, 1}));
+
+    // vector, array and span of the same elements hash their memory
+    auto const vec = std::vector<id12>{{1, 2, 3}, {4, 5, 6}};
+    REQUIRE(hash_of(vec) == ankerl::unordered_dense::detail::wyhash::hash(vec.data(), sizeof(id12) * 2));
+    REQUIRE(hash_of(vec) == hash_of(std::array<id12, 2>{vec[0], vec[1]}));
+    REQUIRE(hash_of(std::vector<uint64_t>{1, 2}) == hash_of(std::array<uint64_t, 2>{1, 2}));
+    REQUIRE(hash_of(std::vector<int>{}) == hash_of(std::array<int, 0>{}));
+    REQUIRE(hash_of(std::vector<uint64_t>{}) != hash_of(std::vector<uint64_t>{0}));
+    REQUIRE(hash_of(std::vector<uint64_t>{0}) != hash_of(std::vector<uint64_t>{0, 0}));
+
+#if ANKERL_UNORDERED_DENSE_CPP_VERSION >= 202002L && defined(__cpp_lib_span)
+    REQUIRE(hash_of(std::span<id12 const>(vec)) == hash_of(vec));
+    REQUIRE(hash_of(std::span<id12 const, 2>(vec.data(), 2)) == hash_of(vec));
+#endif
+
+    auto set = ankerl::unordered_dense::set<id12>();
+    for (uint32_t x = 0; x < 1000; ++x) {
+        set.insert(id12{x, x + 1, x + 2});
+    }
+    REQUIRE(set.size() == 1000);
+    REQUIRE(set.contains(id12{10, 11, 12}));
+    REQUIRE(!set.contains(id12{10, 11, 11}));
+
+    auto map = ankerl::unordered_dense::map<std::vector<int>, int>();
+    map[{1, 2, 3}] = 123;
+    map[{1, 2}] = 12;
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at({1, 2, 3}) == 123);
+}
@@ -0,0 +1,51 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/hash_checks.h> // for is_avalanching_v, hash_of
+
+#include <doctest.h>
+
+#include <array>    // for array
+#include <cstdint>  // for uint64_t, uint32_t
+#include <optional> // for optional, nullopt
+#include <string>   // for string
+#include <tuple>    // for tuple, make_tuple
+#include <utility>  // for pair, make_pair
+
+static_assert(is_avalanching_v<std::pair<int, std::string>>);
+static_assert(is_avalanching_v<std::tuple<int, std::string, double>>);
+static_assert(is_avalanching_v<std::array<uint32_t, 3>>);
+static_assert(is_avalanching_v<std::optional<std::string>>);
+
+TEST_CASE("hash_composite") {
+    // order of elements matters
+    REQUIRE(hash_of(std::make_pair(1, 2)) != hash_of(std::make_pair(2, 1)));
+    REQUIRE(hash_of(std::make_tuple(1, 2, 3)) != hash_of(std::make_tuple(3, 2, 1)));
+    REQUIRE(hash_of(std::array<int, 3>{1, 2, 3}) != hash_of(std::array<int, 3>{3, 2, 1}));
+
+    // equal elements don't cancel each other out
+    REQUIRE(hash_of(std::make_pair(1, 1)) != hash_of(std::make_pair(2, 2)));
+
+    // pair and tuple of the same elements are hashed the same way
+    REQUIRE(hash_of(std::make_pair(1, 2)) == hash_of(std::make_tuple(1, 2)));
+
+    REQUIRE(hash_of(std::optional<int>{}) != hash_of(std::optional<int>{0}));
+    REQUIRE(hash_of(std::optional<int>{1}) != hash_of(std::optional<int>{2}));
+    REQUIRE(hash_of(std::tuple<>{}) == hash_of(std::tuple<>{}));
+}
+
+TEST_CASE("hash_composite_map") {
+    auto map = ankerl::unordered_dense::map<std::pair<uint32_t, uint32_t>, uint64_t>();
+    for (uint32_t x = 0; x < 100; ++x) {
+        for (uint32_t y = 0; y < 100; ++y) {
+            map[{x, y}] = uint64_t{x} * 1000 + y;
+        }
+    }
+    REQUIRE(map.size() == 10000);
+    REQUIRE(map.at({12, 34}) == 12034);
+
+    auto set = ankerl::unordered_dense::set<std::tuple<std::string, std::optional<int>>>();
+    REQUIRE(set.emplace("a", std::nullopt).second);
+    REQUIRE(set.emplace("a", 0).second);
+    REQUIRE(!set.emplace("a", 0).second);
+    REQUIRE(set.size() == 2);
+}
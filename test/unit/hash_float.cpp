@@ -0,0 +1,41 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/hash_checks.h> // for is_avalanching_v
+
+#include <doctest.h>
+
+#include <cstdint> // for uint64_t
+#include <limits>  // for numeric_limits
+
+static_assert(is_avalanching_v<float>);
+static_assert(is_avalanching_v<double>);
+
+namespace {
+
+template <typename T>
+void check() {
+    auto h = ankerl::unordered_dense::hash<T>();
+    REQUIRE(h(T{0}) == h(-T{0}));
+    REQUIRE(h(T{1}) != h(T{-1}));
+    REQUIRE(h(T{1}) != h(T{2}));
+    REQUIRE(h(std::numeric_limits<T>::quiet_NaN()) == h(-std::numeric_limits<T>::quiet_NaN()));
+    REQUIRE(h(std::numeric_limits<T>::quiet_NaN()) == h(std::numeric_limits<T>::signaling_NaN()));
+    REQUIRE(h(std::numeric_limits<T>::infinity()) != h(-std::numeric_limits<T>::infinity()));
+
+    auto map = ankerl::unordered_dense::map<T, int>();
+    map[T{0}] = 1;
+    map[-T{0}] = 2;
+    REQUIRE(map.size() == 1);
+    REQUIRE(map[T{0}] == 2);
+    for (int i = 0; i < 1000; ++i) {
+        map[static_cast<T>(i) * T{0.25}] = i;
+    }
+    REQUIRE(map.size() == 1000);
+}
+
+} // namespace
+
+TEST_CASE("hash_float") {
+    check<float>();
+    check<double>();
+}
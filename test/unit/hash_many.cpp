@@ -0,0 +1,47 @@
+// test the AVX2 code, not just the portable fallback
+#define ANKERL_UNORDERED_DENSE_X86_DISPATCH // NOLINT(cppcoreguidelines-macro-usage)
+#include <ankerl/unordered_dense.h>
+
+#include <third-party/nanobench.h> // for Rng
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t, int64_t, uint32_t
+#include <string>  // for string, to_string
+#include <vector>  // for vector
+
+namespace {
+
+template <typename Key, typename Hash = ankerl::unordered_dense::hash<Key>>
+void check(std::vector<Key> const& keys) {
+    // all sizes, so that both the vectorized and the remaining keys are checked
+    for (size_t count = 0; count <= keys.size(); ++count) {
+        auto hashes = std::vector<uint64_t>(count);
+        ankerl::unordered_dense::hash_many(keys.data(), count, hashes.data(), Hash());
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(hashes[i] == Hash{}(keys[i]));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("hash_many") {
+    auto rng = ankerl::nanobench::Rng(123);
+    auto u64 = std::vector<uint64_t>{0, 1, UINT64_MAX, UINT64_C(0xFFFFFFFF), UINT64_C(0x100000000)};
+    auto i64 = std::vector<int64_t>{0, -1, INT64_MIN, INT64_MAX};
+    auto u32 = std::vector<uint32_t>();
+    auto str = std::vector<std::string>();
+    for (size_t i = 0; i < 37; ++i) {
+        u64.push_back(rng());
+        i64.push_back(static_cast<int64_t>(rng()));
+        u32.push_back(static_cast<uint32_t>(rng()));
+        str.push_back(std::to_string(rng()));
+    }
+    check(u64);
+    check(i64);
+    check(u32);
+    check(str);
+    check<uint64_t, ankerl::unordered_dense::hash_fibonacci<uint64_t>>(u64);
+}
@@ -0,0 +1,95 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t, uint8_t
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <utility>     // for declval
+#include <vector>      // for vector
+
+namespace {
+
+struct key {
+    std::string name;
+    uint32_t id{};
+    uint8_t kind{};
+
+    auto operator==(key const& other) const -> bool {
+        return name == other.name && id == other.id && kind == other.kind;
+    }
+};
+
+struct key_hash {
+    using is_avalanching = void;
+
+    auto operator()(key const& k) const noexcept -> uint64_t {
+        return ankerl::unordered_dense::hasher_state().update(k.name).update(k.id).update(k.kind).finish();
+    }
+};
+
+} // namespace
+
+TEST_CASE("hasher_state") {
+    auto data = std::vector<uint8_t>();
+    for (size_t i = 0; i < 300; ++i) {
+        data.push_back(static_cast<uint8_t>(i * 7 + 3));
+    }
+
+    REQUIRE(ankerl::unordered_dense::hasher_state().finish() == ankerl::unordered_dense::detail::wyhash::hash(nullptr, 0));
+
+    // same result as a single wyhash::hash call, no matter how the data is split up
+    for (size_t len = 0; len < data.size(); ++len) {
+        auto expected = ankerl::unordered_dense::detail::wyhash::hash(data.data(), len);
+        for (size_t chunk : {1U, 3U, 16U, 17U, 47U, 48U, 49U, 100U, 1000U}) {
+            auto state = ankerl::unordered_dense::hasher_state();
+            for (size_t i = 0; i < len; i += chunk) {
+                state.update(data.data() + i, std::min(chunk, len - i));
+            }
+            REQUIRE(state.finish() == expected);
+        }
+    }
+
+    // finish doesn't change the state
+    auto state = ankerl::unordered_dense::hasher_state();
+    state.update(data.data(), 100);
+    auto h100 = state.finish();
+    REQUIRE(h100 == state.finish());
+    state.update(data.data() + 100, 100);
+    REQUIRE(state.finish() == ankerl::unordered_dense::detail::wyhash::hash(data.data(), 200));
+
+    auto str = std::string_view("hello world");
+    REQUIRE(ankerl::unordered_dense::hasher_state().update("hello").update(" world").finish() ==
+            ankerl::unordered_dense::hash<std::string_view>{}(str));
+}
+
+template <typename T>
+using update_t = decltype(std::declval<ankerl::unordered_dense::hasher_state&>().update(std::declval<T const&>()));
+
+// pointers are not hashed by their address
+static_assert(!ankerl::unordered_dense::detail::is_detected_v<update_t, int*>);
+static_assert(!ankerl::unordered_dense::detail::is_detected_v<update_t, void const*>);
+static_assert(ankerl::unordered_dense::detail::is_detected_v<update_t, uint64_t>);
+
+TEST_CASE("hasher_state_c_string") {
+    auto const expected = ankerl::unordered_dense::hasher_state().update(std::string_view("abc")).finish();
+
+    char const* ptr = "abc";
+    REQUIRE(ankerl::unordered_dense::hasher_state().update(ptr).finish() == expected);
+    REQUIRE(ankerl::unordered_dense::hasher_state().update("abc").finish() == expected);
+
+    // a copy of the characters at another address hashes the same
+    auto const copy = std::string(ptr);
+    REQUIRE(ankerl::unordered_dense::hasher_state().update(copy.c_str()).finish() == expected);
+}
+
+TEST_CASE("hasher_state_map") {
+    auto map = ankerl::unordered_dense::map<key, int, key_hash>();
+    map[{"a", 1, 2}] = 1;
+    map[{"a", 1, 3}] = 2;
+    map[{"a", 2, 2}] = 3;
+    map[{"b", 1, 2}] = 4;
+    REQUIRE(map.size() == 4);
+    REQUIRE(map.at({"a", 2, 2}) == 3);
+}
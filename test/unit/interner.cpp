@@ -0,0 +1,137 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t, uint64_t
+#include <memory>      // for unique_ptr
+#include <stdexcept>   // for out_of_range
+#include <string>      // for string, to_string
+#include <string_view> // for string_view
+#include <utility>     // for move
+#include <vector>      // for vector
+
+TEST_CASE("interner") {
+    auto in = ankerl::unordered_dense::interner();
+    REQUIRE(in.empty());
+    REQUIRE(!in.find("hello").has_value());
+
+    REQUIRE(in.intern("hello") == 0);
+    REQUIRE(in.intern("world") == 1);
+    REQUIRE(in.intern("hello") == 0);
+    REQUIRE(in.intern("") == 2);
+    REQUIRE(in.intern("") == 2);
+    REQUIRE(in.size() == 3);
+
+    REQUIRE(in[0] == "hello");
+    REQUIRE(in[1] == "world");
+    REQUIRE(in[2].empty());
+    REQUIRE(in.at(1) == "world");
+    REQUIRE_THROWS_AS(static_cast<void>(in.at(3)), std::out_of_range);
+    REQUIRE(in.find("world") == uint32_t{1});
+    REQUIRE(in.contains(""));
+    REQUIRE(!in.contains("hello!"));
+
+    // the interner owns the characters, the source can go away
+    {
+        auto tmp = std::string("a temporary string that's too long for the small string optimization");
+        REQUIRE(in.intern(tmp) == 3);
+    }
+    REQUIRE(in[3] == "a temporary string that's too long for the small string optimization");
+
+    auto ids = std::vector<uint32_t>();
+    for (auto const& sv : in) {
+        ids.push_back(*in.find(sv));
+    }
+    REQUIRE(ids == std::vector<uint32_t>{0, 1, 2, 3});
+
+    in.clear();
+    REQUIRE(in.empty());
+    REQUIRE(in.intern("world") == 0);
+}
+
+TEST_CASE("interner_many") {
+    static constexpr size_t num_strings = 10000;
+    auto in = ankerl::unordered_dense::interner();
+    in.reserve(num_strings);
+
+    // string_views that were handed out stay valid while the interner grows
+    auto views = std::vector<std::string_view>();
+    for (size_t i = 0; i < num_strings; ++i) {
+        auto str = "str_" + std::to_string(i);
+        REQUIRE(in.intern(str) == i);
+        views.push_back(in[static_cast<uint32_t>(i)]);
+    }
+    for (size_t i = 0; i < num_strings; ++i) {
+        REQUIRE(views[i] == "str_" + std::to_string(i));
+        REQUIRE(in.intern(views[i]) == i);
+    }
+
+    auto copy = in;
+    REQUIRE(copy.size() == num_strings);
+    for (uint32_t i = 0; i < num_strings; ++i) {
+        REQUIRE(copy[i] == in[i]);
+        REQUIRE(copy[i].data() != in[i].data());
+    }
+
+    auto moved = std::move(in);
+    REQUIRE(moved.size() == num_strings);
+    REQUIRE(moved[17].data() == views[17].data());
+    REQUIRE(in.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    REQUIRE(in.intern("new") == 0);
+
+    copy = moved;
+    REQUIRE(copy.find("str_9999") == uint32_t{9999});
+}
+
+TEST_CASE("interner_chars_only_for_new_strings") {
+    auto in = ankerl::unordered_dense::interner();
+    REQUIRE(in.intern("ab") == 0);
+    REQUIRE(in.intern("ab") == 0);
+    REQUIRE(in.intern("cd") == 1);
+
+    // looking up "ab" again didn't append its characters
+    REQUIRE(in[1].data() == in[0].data() + 2);
+}
+
+namespace {
+
+struct counting_hash {
+    using is_avalanching = void;
+
+    static inline size_t num_calls = 0;
+
+    auto operator()(std::string_view str) const noexcept -> uint64_t {
+        ++num_calls;
+        return ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+};
+
+} // namespace
+
+TEST_CASE("interner_arena_key_hashes_once") {
+    using set_t = ankerl::unordered_dense::set<std::string_view,
+                                               ankerl::unordered_dense::detail::arena_key_hash<counting_hash>,
+                                               ankerl::unordered_dense::detail::arena_key_equal<std::equal_to<std::string_view>>>;
+    auto chars = std::unique_ptr<ankerl::unordered_dense::arena>();
+    auto s = set_t();
+    s.reserve(100);
+
+    counting_hash::num_calls = 0;
+    auto key = ankerl::unordered_dense::detail::arena_key("hello", chars);
+    REQUIRE(s.emplace(key).second);
+    REQUIRE(counting_hash::num_calls == 1);
+    REQUIRE(chars != nullptr);
+    REQUIRE(s.values()[0] == "hello");
+
+    // an existing key is neither copied nor hashed twice
+    auto const capacity = chars->capacity();
+    auto again = ankerl::unordered_dense::detail::arena_key("hello", chars);
+    REQUIRE(!s.emplace(again).second);
+    REQUIRE(counting_hash::num_calls == 2);
+    REQUIRE(chars->capacity() == capacity);
+
+    auto other = ankerl::unordered_dense::detail::arena_key("world", chars);
+    REQUIRE(s.emplace(other).second);
+    REQUIRE(s.values()[1].data() == s.values()[0].data() + 5);
+}
@@ -0,0 +1,103 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+#include <string>  // for string
+#include <utility> // for pair
+#include <vector>  // for vector
+
+namespace {
+
+// owns memory somewhere else that only it knows about
+struct blob {
+    size_t m_bytes;
+};
+
+} // namespace
+
+template <>
+struct ankerl::unordered_dense::heap_size<blob> {
+    auto operator()(blob const& b) const noexcept -> size_t {
+        return b.m_bytes;
+    }
+};
+
+static_assert(!ankerl::unordered_dense::detail::has_heap_size<uint64_t>);
+static_assert(ankerl::unordered_dense::detail::has_heap_size<std::string>);
+static_assert(ankerl::unordered_dense::detail::has_heap_size<std::vector<int>>);
+static_assert(ankerl::unordered_dense::detail::has_heap_size<blob>);
+
+TEST_CASE("memory_usage") {
+    using map_t = ankerl::unordered_dense::map<uint64_t, uint64_t>;
+    using value_t = std::pair<uint64_t, uint64_t>;
+
+    auto map = map_t();
+    auto mem = map.memory_usage();
+    REQUIRE(mem.bucket_bytes == 0);
+    REQUIRE(mem.values_capacity_bytes == 0);
+    REQUIRE(mem.values_bytes == 0);
+    REQUIRE(mem.heap_bytes == 0);
+    REQUIRE(mem.total_bytes == 0);
+    REQUIRE(mem.overhead_per_element == doctest::Approx(0.0));
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    mem = map.memory_usage();
+    REQUIRE(mem.bucket_bytes == map.bucket_count() * sizeof(ankerl::unordered_dense::bucket_type::standard));
+    REQUIRE(mem.values_capacity_bytes == map.values().capacity() * sizeof(value_t));
+    REQUIRE(mem.values_bytes == 1000 * sizeof(value_t));
+    REQUIRE(mem.heap_bytes == 0);
+    REQUIRE(mem.total_bytes == mem.bucket_bytes + mem.values_capacity_bytes);
+    auto const overhead = static_cast<double>(mem.total_bytes - mem.values_bytes) / 1000.0;
+    REQUIRE(mem.overhead_per_element == doctest::Approx(overhead));
+    REQUIRE(map.stats().bucket_bytes == mem.bucket_bytes);
+    REQUIRE(map.stats().value_bytes == mem.values_capacity_bytes);
+
+    for (uint64_t i = 0; i < 900; ++i) {
+        map.erase(i);
+    }
+    REQUIRE(map.memory_usage().total_bytes == mem.total_bytes);
+    map.rehash(0);
+    REQUIRE(map.memory_usage().values_bytes == 100 * sizeof(value_t));
+    REQUIRE(map.memory_usage().total_bytes < mem.total_bytes / 4);
+}
+
+TEST_CASE("memory_usage_heap_size") {
+    auto map = ankerl::unordered_dense::map<std::string, std::vector<int>>();
+    map["short"];
+    auto const long_key = std::string(100, 'x');
+    map[long_key].reserve(10);
+    auto const& stored_key = map.find(long_key)->first;
+    REQUIRE(map.memory_usage().heap_bytes == stored_key.capacity() + 1 + 10 * sizeof(int));
+
+    auto blobs = ankerl::unordered_dense::map<uint64_t, blob>();
+    blobs.try_emplace(1, blob{100});
+    blobs.try_emplace(2, blob{23});
+    auto const mem = blobs.memory_usage();
+    REQUIRE(mem.heap_bytes == 123);
+    REQUIRE(mem.total_bytes == mem.bucket_bytes + mem.values_capacity_bytes + 123);
+
+    auto set = ankerl::unordered_dense::set<std::string>();
+    set.insert(long_key);
+    set.insert(long_key + long_key);
+    REQUIRE(set.memory_usage().heap_bytes >= 302);
+
+    auto bits = ankerl::unordered_dense::map<uint64_t, std::vector<bool>>();
+    bits[1].reserve(1000);
+    auto const capacity = bits[1].capacity();
+    REQUIRE(bits.memory_usage().heap_bytes == (capacity + 7) / 8);
+}
+
+TEST_CASE("memory_usage_string_map") {
+    auto map = ankerl::unordered_dense::string_map<int>();
+    REQUIRE(map.memory_usage().heap_bytes == 0);
+    for (int i = 0; i < 100; ++i) {
+        map.try_emplace(std::to_string(i) + "some longer key", i);
+    }
+    auto const mem = map.memory_usage();
+    REQUIRE(mem.heap_bytes >= map.key_bytes());
+    REQUIRE(mem.total_bytes == mem.bucket_bytes + mem.values_capacity_bytes + mem.heap_bytes);
+}
@@ -0,0 +1,31 @@
+// By default there's no x86-64 dispatch, the header doesn't include <immintrin.h>. hash_aes.cpp and hash_many.cpp opt in,
+// they are in a different inline namespace so all translation units can be linked together.
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <string>      // for string
+#include <type_traits> // for is_same_v
+#include <vector>      // for vector
+
+static_assert(std::is_same_v<ankerl::unordered_dense::v3_0_2::map<int, int>, ankerl::unordered_dense::map<int, int>>);
+static_assert(!ANKERL_UNORDERED_DENSE_HAS_X86_DISPATCH);
+
+TEST_CASE("no_x86_dispatch") {
+    // hash_aes is wyhash
+    auto const str = std::string(100, 'x');
+    REQUIRE(ankerl::unordered_dense::hash_aes<std::string>{}(str) == ankerl::unordered_dense::hash<std::string>{}(str));
+
+    // hash_many gives the same results without AVX2
+    auto keys = std::vector<uint64_t>();
+    for (uint64_t i = 0; i < 100; ++i) {
+        keys.push_back(i * 12345);
+    }
+    auto hashes = std::vector<uint64_t>(keys.size());
+    ankerl::unordered_dense::hash_many(keys.data(), keys.size(), hashes.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(hashes[i] == ankerl::unordered_dense::hash<uint64_t>{}(keys[i]));
+    }
+}
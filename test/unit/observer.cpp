@@ -0,0 +1,170 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+#include <utility> // for pair, move
+#include <vector>  // for vector
+
+namespace {
+
+// observers only have static functions, so the events are collected globally
+struct recording_observer {
+    static inline std::vector<ankerl::unordered_dense::rehash_event> rehashes{};              // NOLINT
+    static inline std::vector<ankerl::unordered_dense::values_growth_event> values_growths{}; // NOLINT
+
+    static void on_rehash(ankerl::unordered_dense::rehash_event const& event) noexcept {
+        rehashes.push_back(event);
+    }
+
+    static void on_values_growth(ankerl::unordered_dense::values_growth_event const& event) noexcept {
+        values_growths.push_back(event);
+    }
+
+    static void clear() {
+        rehashes.clear();
+        values_growths.clear();
+    }
+};
+
+using map_t = ankerl::unordered_dense::map<uint64_t,
+                                           uint64_t,
+                                           ankerl::unordered_dense::hash<uint64_t>,
+                                           std::equal_to<uint64_t>,
+                                           std::allocator<std::pair<uint64_t, uint64_t>>,
+                                           ankerl::unordered_dense::bucket_type::standard,
+                                           recording_observer>;
+
+using set_t = ankerl::unordered_dense::set<uint64_t,
+                                           ankerl::unordered_dense::hash<uint64_t>,
+                                           std::equal_to<uint64_t>,
+                                           std::allocator<uint64_t>,
+                                           ankerl::unordered_dense::bucket_type::standard,
+                                           ankerl::unordered_dense::usdt_observer>;
+
+} // namespace
+
+TEST_CASE("observer_growth") {
+    recording_observer::clear();
+    {
+        auto map = map_t();
+        for (uint64_t i = 0; i < 1000; ++i) {
+            map[i] = i;
+        }
+        auto const& rehashes = recording_observer::rehashes;
+        REQUIRE(!rehashes.empty());
+        for (size_t i = 1; i < rehashes.size(); ++i) {
+            REQUIRE(rehashes[i].old_bucket_count == rehashes[i - 1].new_bucket_count);
+            REQUIRE(rehashes[i].new_bucket_count == rehashes[i].old_bucket_count * 2);
+            REQUIRE(rehashes[i].duration.count() >= 0);
+        }
+        REQUIRE(rehashes.back().new_bucket_count == map.bucket_count());
+
+        auto const& growths = recording_observer::values_growths;
+        REQUIRE(!growths.empty());
+        for (auto const& ev : growths) {
+            REQUIRE(ev.new_capacity > ev.old_capacity);
+            REQUIRE(ev.size <= ev.new_capacity);
+        }
+        REQUIRE(growths.back().new_capacity == map.values().capacity());
+    }
+    REQUIRE(recording_observer::rehashes.size() > 5);
+}
+
+TEST_CASE("observer_reserve_rehash") {
+    recording_observer::clear();
+    auto map = map_t();
+    map.reserve(1000);
+    REQUIRE(recording_observer::rehashes.size() == 1);
+    REQUIRE(recording_observer::rehashes.back().old_bucket_count == 0);
+    REQUIRE(recording_observer::rehashes.back().new_bucket_count == map.bucket_count());
+    REQUIRE(recording_observer::values_growths.size() == 1);
+    REQUIRE(recording_observer::values_growths.back().new_capacity >= 1000);
+
+    // no growth needed
+    for (uint64_t i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    REQUIRE(recording_observer::rehashes.size() == 1);
+    REQUIRE(recording_observer::values_growths.size() == 1);
+
+    // shrinking is a rehash too
+    map.rehash(0);
+    REQUIRE(recording_observer::rehashes.size() == 2);
+    REQUIRE(recording_observer::rehashes.back().new_bucket_count < recording_observer::rehashes.back().old_bucket_count);
+    REQUIRE(recording_observer::rehashes.back().size == 100);
+
+    std::erase_if(map, [](auto const& kv) {
+        return kv.first % 2 == 0;
+    });
+    REQUIRE(map.size() == 50);
+}
+
+TEST_CASE("observer_copy_assignment") {
+    auto big = map_t();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        big[i] = i;
+    }
+    auto small = map_t();
+    small[1] = 1;
+
+    auto const small_bucket_count = small.bucket_count();
+    recording_observer::clear();
+    small = big;
+    REQUIRE(small == big);
+    REQUIRE(recording_observer::values_growths.size() == 1);
+    REQUIRE(recording_observer::values_growths.back().old_capacity < recording_observer::values_growths.back().new_capacity);
+    REQUIRE(recording_observer::values_growths.back().size == 1000);
+    REQUIRE(recording_observer::rehashes.size() == 1);
+    REQUIRE(recording_observer::rehashes.back().old_bucket_count == small_bucket_count);
+    REQUIRE(recording_observer::rehashes.back().new_bucket_count == big.bucket_count());
+    REQUIRE(recording_observer::rehashes.back().size == 1000);
+
+    // enough capacity, no growth. The buckets are still allocated again.
+    recording_observer::clear();
+    small = big;
+    REQUIRE(recording_observer::values_growths.empty());
+    REQUIRE(recording_observer::rehashes.size() == 1);
+    REQUIRE(recording_observer::rehashes.back().old_bucket_count == big.bucket_count());
+    REQUIRE(recording_observer::rehashes.back().new_bucket_count == big.bucket_count());
+}
+
+TEST_CASE("observer_replace") {
+    auto map = map_t();
+    map[1] = 1;
+    auto const old_bucket_count = map.bucket_count();
+
+    auto values = std::vector<std::pair<uint64_t, uint64_t>>();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        values.emplace_back(i, i);
+    }
+    recording_observer::clear();
+    map.replace(std::move(values));
+    REQUIRE(map.size() == 1000);
+    REQUIRE(recording_observer::rehashes.size() == 1);
+    REQUIRE(recording_observer::rehashes.back().old_bucket_count == old_bucket_count);
+    REQUIRE(recording_observer::rehashes.back().new_bucket_count == map.bucket_count());
+    REQUIRE(recording_observer::rehashes.back().size == 1000);
+
+    // the buckets are large enough, they are only cleared and filled again
+    values = std::vector<std::pair<uint64_t, uint64_t>>{{1, 1}, {2, 2}, {1, 3}};
+    recording_observer::clear();
+    map.replace(std::move(values));
+    REQUIRE(map.size() == 2);
+    REQUIRE(recording_observer::rehashes.empty());
+}
+
+static_assert(!ankerl::unordered_dense::detail::is_enabled_observer<ankerl::unordered_dense::no_observer>());
+static_assert(ankerl::unordered_dense::detail::is_enabled_observer<recording_observer>());
+static_assert(ankerl::unordered_dense::detail::is_enabled_observer<ankerl::unordered_dense::usdt_observer>() ==
+              (ANKERL_UNORDERED_DENSE_HAS_USDT != 0));
+
+TEST_CASE("observer_usdt") {
+    auto set = set_t();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        set.insert(i);
+    }
+    set.reserve(10000);
+    REQUIRE(set.size() == 1000);
+}
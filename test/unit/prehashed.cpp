@@ -0,0 +1,73 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/hash_checks.h> // for is_avalanching_hash_v
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <string>      // for string, to_string
+#include <string_view> // for string_view
+
+namespace {
+
+size_t num_hash_calls = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+struct counting_hash {
+    using is_avalanching = void;
+
+    auto operator()(std::string_view sv) const noexcept -> uint64_t {
+        ++num_hash_calls;
+        return ankerl::unordered_dense::hash<std::string_view>{}(sv);
+    }
+};
+
+using hashed_t = ankerl::unordered_dense::prehashed<std::string_view, counting_hash>;
+using hash_t = ankerl::unordered_dense::prehashed_hash<counting_hash>;
+using eq_t = ankerl::unordered_dense::prehashed_equal;
+
+} // namespace
+
+static_assert(is_avalanching_hash_v<hash_t>);
+static_assert(!is_avalanching_hash_v<ankerl::unordered_dense::prehashed_hash<std::hash<std::string>>>);
+
+TEST_CASE("prehashed") {
+    auto map1 = ankerl::unordered_dense::map<std::string, int, hash_t, eq_t>();
+    auto map2 = ankerl::unordered_dense::map<std::string, int, hash_t, eq_t>();
+    for (int i = 0; i < 100; ++i) {
+        map1[std::to_string(i)] = i;
+        map2[std::to_string(i)] = i * 2;
+    }
+
+    num_hash_calls = 0;
+    auto key = hashed_t("42");
+    REQUIRE(num_hash_calls == 1);
+    REQUIRE(map1.find(key)->second == 42);
+    REQUIRE(map2.find(key)->second == 84);
+    REQUIRE(map1.contains(key));
+    REQUIRE(num_hash_calls == 1);
+    REQUIRE(!map1.contains(hashed_t("1000")));
+
+    // plain keys still work
+    REQUIRE(map1.find(std::string_view("42"))->second == 42);
+    REQUIRE(map1.count(std::string("43")) == 1);
+}
+
+TEST_CASE("prehashed_key") {
+    using ankerl::unordered_dense::hashed_string;
+    using ankerl::unordered_dense::hashed_string_view;
+
+    auto map = ankerl::unordered_dense::map<hashed_string, int, ankerl::unordered_dense::prehashed_hash<>, eq_t>();
+    for (int i = 0; i < 1000; ++i) {
+        map.try_emplace(hashed_string(std::to_string(i)), i);
+    }
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.find(hashed_string_view("123"))->second == 123);
+    REQUIRE(map.find(hashed_string_view("123"))->first.key() == "123");
+    REQUIRE(map.find(std::string_view("124"))->second == 124);
+    REQUIRE(map.find(hashed_string_view("1234")) == map.end());
+
+    REQUIRE(hashed_string("abc") == hashed_string_view("abc"));
+    REQUIRE(hashed_string("abc") != hashed_string_view("abd"));
+    REQUIRE(hashed_string("abc").hash() == ankerl::unordered_dense::hash<std::string>{}("abc"));
+}
@@ -0,0 +1,124 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/counter.h>
+
+#include <doctest.h>
+
+#include <cstddef> // for size_t
+#include <memory>  // for unique_ptr, make_unique, shared_ptr
+#include <string>  // for string
+#include <utility> // for pair, move
+
+static_assert(ankerl::unordered_dense::is_trivially_relocatable_v<int>);
+static_assert(ankerl::unordered_dense::is_trivially_relocatable_v<std::unique_ptr<int>>);
+static_assert(ankerl::unordered_dense::is_trivially_relocatable_v<std::shared_ptr<int>>);
+static_assert(ankerl::unordered_dense::is_trivially_relocatable_v<std::pair<size_t, std::unique_ptr<int>>>);
+static_assert(!ankerl::unordered_dense::is_trivially_relocatable_v<std::string>);
+static_assert(!ankerl::unordered_dense::is_trivially_relocatable_v<counter::obj>);
+
+namespace {
+
+template <typename T>
+using vec_t = ankerl::unordered_dense::relocating_vector<T>;
+
+template <typename Key, typename T>
+using map_t = ankerl::unordered_dense::
+    map<Key, T, ankerl::unordered_dense::hash<Key>, std::equal_to<Key>, vec_t<std::pair<Key, T>>>;
+
+} // namespace
+
+TEST_CASE("relocating_vector") {
+    auto vec = vec_t<std::unique_ptr<int>>();
+    REQUIRE(vec.empty());
+    for (int i = 0; i < 100; ++i) {
+        vec.emplace_back(std::make_unique<int>(i));
+    }
+    REQUIRE(vec.size() == 100);
+    REQUIRE(vec.capacity() >= 100);
+    REQUIRE(*vec.front() == 0);
+    REQUIRE(*vec.back() == 99);
+
+    vec.replace_with_back(10);
+    REQUIRE(vec.size() == 99);
+    REQUIRE(*vec[10] == 99);
+    vec.replace_with_back(vec.size() - 1);
+    REQUIRE(vec.size() == 98);
+    REQUIRE(*vec.back() == 97);
+
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() == vec.size());
+
+    auto vec2 = std::move(vec);
+    REQUIRE(vec.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    REQUIRE(vec2.size() == 98);
+
+    auto copies = vec_t<std::string>();
+    copies.emplace_back("hello, this string is too long for the small string optimization");
+    for (int i = 0; i < 10; ++i) {
+        // copy from an element of the same container, even while it grows
+        copies.push_back(copies.front());
+    }
+    auto copies2 = copies;
+    REQUIRE(copies2.size() == 11);
+    REQUIRE(copies2.back() == copies.front());
+}
+
+TEST_CASE("relocating_vector_map") {
+    auto map = map_t<size_t, std::unique_ptr<size_t>>();
+    for (size_t i = 0; i < 1000; ++i) {
+        map.try_emplace(i, std::make_unique<size_t>(i));
+    }
+    REQUIRE(map.size() == 1000);
+
+    for (size_t i = 0; i < 1000; i += 3) {
+        REQUIRE(map.erase(i) == 1);
+    }
+    REQUIRE(map.size() == 666);
+    for (size_t i = 0; i < 1000; ++i) {
+        auto it = map.find(i);
+        if (i % 3 == 0) {
+            REQUIRE(it == map.end());
+        } else {
+            REQUIRE(it != map.end());
+            REQUIRE(*it->second == i);
+        }
+    }
+
+    auto container = std::move(map).extract();
+    REQUIRE(container.size() == 666);
+    container.emplace_back(1, std::make_unique<size_t>(1));
+    container.emplace_back(2, std::make_unique<size_t>(2));
+
+    // duplicates are removed
+    auto map2 = map_t<size_t, std::unique_ptr<size_t>>();
+    map2.replace(std::move(container));
+    REQUIRE(map2.size() == 666);
+    for (auto const& [key, val] : map2) {
+        REQUIRE(key == *val);
+    }
+}
+
+TEST_CASE("relocating_vector_map_counter") {
+    auto counts = counter();
+    INFO(counts);
+
+    // counter::obj is not trivially relocatable, so this uses move construction & destruction
+    auto map = map_t<counter::obj, counter::obj>();
+    for (size_t i = 0; i < 100; ++i) {
+        map.try_emplace(counter::obj(i, counts), i, counts);
+    }
+    for (size_t i = 0; i < 100; i += 2) {
+        REQUIRE(map.erase(counter::obj(i, counts)) == 1);
+    }
+    REQUIRE(map.size() == 50);
+    for (size_t i = 0; i < 100; ++i) {
+        REQUIRE(map.contains(counter::obj(i, counts)) == (i % 2 == 1));
+    }
+
+    auto map2 = map;
+    REQUIRE(map2 == map);
+    map.clear();
+    REQUIRE(map.empty());
+    map = std::move(map2);
+    REQUIRE(map.size() == 50);
+}
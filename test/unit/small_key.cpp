@@ -0,0 +1,69 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <functional>  // for equal_to
+#include <stdexcept>   // for length_error
+#include <string>      // for string, to_string
+#include <string_view> // for string_view
+#include <type_traits> // for is_trivially_copyable_v
+
+using small_key_t = ankerl::unordered_dense::small_key<23>;
+
+static_assert(sizeof(small_key_t) == 24);
+static_assert(std::is_trivially_copyable_v<small_key_t>);
+static_assert(ankerl::unordered_dense::is_trivially_relocatable_v<small_key_t>);
+static_assert(small_key_t::capacity() == 23);
+
+TEST_CASE("small_key") {
+    auto const a = small_key_t("hello");
+    REQUIRE(a.size() == 5);
+    REQUIRE(!a.empty());
+    REQUIRE(a.str() == "hello");
+    REQUIRE(a == small_key_t(std::string_view("hello")));
+    REQUIRE(a != small_key_t("hell"));
+    REQUIRE(a == std::string_view("hello"));
+    REQUIRE(std::string_view("hello") == a);
+    REQUIRE(a != std::string_view("hello!"));
+    REQUIRE(small_key_t().empty());
+    REQUIRE(small_key_t() == small_key_t(""));
+
+    auto const longest = std::string(23, 'x');
+    REQUIRE(small_key_t(longest).str() == longest);
+    REQUIRE_THROWS_AS(small_key_t(std::string(24, 'x')), std::length_error);
+
+    // same hash as std::string_view, for all lengths
+    auto h = ankerl::unordered_dense::hash<small_key_t>();
+    for (size_t len = 0; len <= 23; ++len) {
+        auto str = std::string(len, 'a');
+        REQUIRE(h(small_key_t(str)) == ankerl::unordered_dense::hash<std::string_view>()(str));
+        REQUIRE(h(small_key_t(str)) == h(std::string_view(str)));
+    }
+}
+
+TEST_CASE("small_key_map") {
+    using map_t = ankerl::unordered_dense::map<small_key_t, size_t, ankerl::unordered_dense::hash<small_key_t>, std::equal_to<>>;
+
+    auto map = map_t();
+    for (size_t i = 0; i < 1000; ++i) {
+        map[small_key_t("id_" + std::to_string(i))] = i;
+    }
+    REQUIRE(map.size() == 1000);
+
+    // transparent lookup with string_view, std::string and const char*
+    REQUIRE(map.find(std::string_view("id_17"))->second == 17);
+    REQUIRE(map.contains(std::string("id_999")));
+    REQUIRE(map.count("id_0") == 1);
+    REQUIRE(!map.contains("id_1000"));
+    REQUIRE(map.at(small_key_t("id_5")) == 5);
+
+    // keys are inserted from string_view too
+    map[std::string_view("new")] = 1234;
+    REQUIRE(map.at(small_key_t("new")) == 1234);
+    REQUIRE(map.erase("new") == 1);
+    REQUIRE(map.size() == 1000);
+
+    auto map2 = map;
+    REQUIRE(map2 == map);
+}
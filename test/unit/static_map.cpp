@@ -0,0 +1,135 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/counter.h>
+
+#include <doctest.h>
+
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
+#include <stdexcept>   // for overflow_error
+#include <string>      // for string
+#include <type_traits> // for is_nothrow_move_constructible_v
+#include <utility>     // for move
+
+using map_t = ankerl::unordered_dense::static_map<uint64_t, uint64_t, 256>;
+using set_t = ankerl::unordered_dense::static_set<uint64_t, 5>;
+
+static_assert(map_t::max_size() == 256);
+static_assert(map_t::max_bucket_count() == 512);
+static_assert(set_t::max_size() == 5);
+static_assert(set_t::max_bucket_count() == 8);
+
+namespace {
+
+// the values are moved one by one, so this can only be noexcept when that is
+struct throwing_move {
+    std::string str{};
+
+    throwing_move() = default;
+    throwing_move(throwing_move const&) = default;
+    throwing_move(throwing_move&& other) noexcept(false)
+        : str(std::move(other.str)) {}
+    auto operator=(throwing_move const&) -> throwing_move& = default;
+    auto operator=(throwing_move&&) -> throwing_move& = default;
+    ~throwing_move() = default;
+};
+
+static_assert(std::is_nothrow_move_constructible_v<map_t>);
+static_assert(std::is_nothrow_move_constructible_v<set_t>);
+static_assert(!std::is_nothrow_move_constructible_v<ankerl::unordered_dense::static_map<uint64_t, throwing_move, 8>>);
+static_assert(std::is_nothrow_move_constructible_v<ankerl::unordered_dense::map<uint64_t, throwing_move>>);
+
+// true when the memory of the element is within the map object itself
+template <typename Map>
+auto is_inline(Map const& map, typename Map::value_type const& val) -> bool {
+    auto const* p = reinterpret_cast<char const*>(&val);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const* begin = reinterpret_cast<char const*>(&map); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return p >= begin && p < begin + sizeof(Map);
+}
+
+} // namespace
+
+TEST_CASE("static_map") {
+    auto map = map_t();
+    REQUIRE(map.bucket_count() == 0);
+    for (uint64_t i = 0; i < map_t::max_size(); ++i) {
+        REQUIRE(map.try_emplace(i, i * 2).second);
+    }
+    REQUIRE(map.size() == 256);
+    REQUIRE(map.bucket_count() == map_t::max_bucket_count());
+    REQUIRE_THROWS_AS(map.try_emplace(256, 0), std::overflow_error);
+    REQUIRE(map.size() == 256);
+
+    for (auto const& kv : map) {
+        REQUIRE(is_inline(map, kv));
+        REQUIRE(kv.second == kv.first * 2);
+    }
+
+    // erase makes room for another element
+    REQUIRE(map.erase(17) == 1);
+    REQUIRE(map.try_emplace(1000, 1).second);
+    REQUIRE(map.contains(1000));
+    REQUIRE(!map.contains(17));
+
+    auto map2 = map;
+    REQUIRE(map2 == map);
+    auto map3 = std::move(map2);
+    REQUIRE(map3 == map);
+    REQUIRE(map2.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+
+    // the moved from map's buckets are stale, but it is usable again
+    REQUIRE(!map2.contains(1000));
+    map2[1000] = 5;
+    REQUIRE(map2.size() == 1);
+    REQUIRE(map2.at(1000) == 5);
+    REQUIRE(!map2.contains(3));
+
+    map.clear();
+    REQUIRE(map.empty());
+    map[3] = 4;
+    REQUIRE(map.size() == 1);
+    REQUIRE(map.at(3) == 4);
+
+    map.reserve(1000);
+    REQUIRE(map.bucket_count() == map_t::max_bucket_count());
+}
+
+TEST_CASE("static_set") {
+    auto set = set_t();
+    for (uint64_t i = 0; i < 5; ++i) {
+        REQUIRE(set.insert(i).second);
+        REQUIRE(!set.insert(i).second);
+    }
+    REQUIRE_THROWS_AS(set.insert(5), std::overflow_error);
+    REQUIRE(set.size() == 5);
+
+    // inserting an existing key into a full set is fine
+    REQUIRE(!set.insert(3).second);
+    REQUIRE(!set.emplace(4).second);
+    for (uint64_t i = 0; i < 5; ++i) {
+        REQUIRE(set.contains(i));
+    }
+}
+
+TEST_CASE("static_map_counter") {
+    auto counts = counter();
+    INFO(counts);
+
+    using counter_map_t = ankerl::unordered_dense::static_map<counter::obj, counter::obj, 100>;
+    {
+        auto map = counter_map_t();
+        for (size_t i = 0; i < 100; ++i) {
+            map.try_emplace(counter::obj(i, counts), i, counts);
+        }
+        for (size_t i = 0; i < 100; i += 2) {
+            REQUIRE(map.erase(counter::obj(i, counts)) == 1);
+        }
+        auto map2 = map;
+        REQUIRE(map2.size() == 50);
+        map = std::move(map2);
+        REQUIRE(map.size() == 50);
+        std::swap(map, map2);
+        REQUIRE(map2.size() == 50);
+    }
+    REQUIRE(counts.ctor() + counts.default_ctor() + counts.copy_ctor() + counts.move_ctor() == counts.dtor());
+}
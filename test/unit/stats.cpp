@@ -0,0 +1,91 @@
+#include <ankerl/unordered_dense.h>
+
+#include <doctest.h>
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <functional> // for equal_to
+#include <numeric>    // for accumulate
+
+namespace {
+
+// Keeps only the upper 8 bits of a good hash: the fingerprint is always 0, so every element with the same home bucket is
+// a fingerprint collision.
+struct hash_without_fingerprint {
+    using is_avalanching = void;
+
+    auto operator()(uint64_t key) const noexcept -> uint64_t {
+        return ankerl::unordered_dense::detail::wyhash::hash(key) & UINT64_C(0xFF00000000000000);
+    }
+};
+
+struct counting_equal {
+    size_t* m_count;
+
+    auto operator()(uint64_t a, uint64_t b) const -> bool {
+        ++*m_count;
+        return a == b;
+    }
+};
+
+} // namespace
+
+TEST_CASE("stats_empty") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    auto st = map.stats();
+    REQUIRE(st.distance_histogram.empty());
+    REQUIRE(st.num_elements == 0);
+    REQUIRE(st.num_buckets == 0);
+    REQUIRE(st.max_probe_length == 0);
+    REQUIRE(st.mean_probe_length == 0.0);
+    REQUIRE(st.fingerprint_collisions == 0);
+    REQUIRE(st.bucket_bytes == 0);
+}
+
+TEST_CASE("stats") {
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t>();
+    for (uint64_t i = 0; i < 10000; ++i) {
+        map[i] = i;
+    }
+    auto st = map.stats();
+    REQUIRE(st.num_elements == 10000);
+    REQUIRE(st.num_buckets == map.bucket_count());
+    REQUIRE(std::accumulate(st.distance_histogram.begin(), st.distance_histogram.end(), size_t{}) == map.size());
+    REQUIRE(st.max_probe_length == st.distance_histogram.size());
+    REQUIRE(st.distance_histogram.back() > 0);
+    REQUIRE(st.mean_probe_length >= 1.0);
+    REQUIRE(st.mean_probe_length < 3.0);
+    REQUIRE(st.occupancy == doctest::Approx(static_cast<double>(map.size()) / static_cast<double>(map.bucket_count())));
+    REQUIRE(st.fingerprint_collision_rate < 0.02);
+    REQUIRE(st.bucket_bytes == map.bucket_count() * sizeof(decltype(map)::bucket_type));
+    REQUIRE(st.value_bytes == map.values().capacity() * sizeof(decltype(map)::value_type));
+}
+
+TEST_CASE("stats_fingerprint_collisions") {
+    size_t count = 0;
+    auto map = ankerl::unordered_dense::map<uint64_t, uint64_t, hash_without_fingerprint, counting_equal>(
+        0, hash_without_fingerprint{}, counting_equal{&count});
+    for (uint64_t i = 0; i < 200; ++i) {
+        map[i] = i;
+    }
+
+    // look up each element once, all comparisons except the one with the element itself are collisions
+    count = 0;
+    for (uint64_t i = 0; i < 200; ++i) {
+        REQUIRE(map.find(i)->second == i);
+    }
+    auto st = map.stats();
+    REQUIRE(st.fingerprint_collisions == count - map.size());
+    REQUIRE(st.fingerprint_collisions > 0);
+    REQUIRE(st.fingerprint_collision_rate > 0.1);
+}
+
+TEST_CASE("stats_static_map") {
+    auto map = ankerl::unordered_dense::static_map<uint64_t, uint64_t, 100>();
+    for (uint64_t i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    auto st = map.stats();
+    REQUIRE(st.num_elements == 100);
+    REQUIRE(st.bucket_bytes == decltype(map)::max_bucket_count() * sizeof(decltype(map)::bucket_type));
+}
@@ -0,0 +1,190 @@
+#include <ankerl/unordered_dense.h>
+
+#include <app/counter.h>
+
+#include <doctest.h>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <stdexcept>   // for out_of_range, runtime_error
+#include <string>      // for string, to_string
+#include <string_view> // for string_view
+#include <utility>     // for move
+
+using map_t = ankerl::unordered_dense::string_map<size_t>;
+
+TEST_CASE("string_map") {
+    auto map = map_t();
+    REQUIRE(map.empty());
+
+    REQUIRE(map.try_emplace("hello", 1).second);
+    REQUIRE(!map.try_emplace("hello", 2).second);
+    REQUIRE(map.insert_or_assign(std::string("world"), 3).second);
+    REQUIRE(!map.insert_or_assign("world", 4).second);
+    map[""] = 5;
+    REQUIRE(map.insert({"foo", 6}).second);
+    REQUIRE(map.size() == 4);
+    REQUIRE(map.key_bytes() == 13);
+
+    // lookup with string_view, const char* and std::string
+    REQUIRE(map.at(std::string_view("hello")) == 1);
+    REQUIRE(map.at("world") == 4);
+    REQUIRE(map.find(std::string("")) != map.end());
+    REQUIRE(map.find(std::string(""))->second == 5);
+    REQUIRE(map.contains("foo"));
+    REQUIRE(map.count("bar") == 0);
+    REQUIRE_THROWS_AS(static_cast<void>(map.at("bar")), std::out_of_range);
+
+    // the map owns the characters of the keys
+    {
+        auto tmp = std::string("a temporary string that's too long for the small string optimization");
+        map[tmp] = 7;
+    }
+    REQUIRE(map.at("a temporary string that's too long for the small string optimization") == 7);
+
+    REQUIRE(map.erase("hello") == 1);
+    REQUIRE(map.erase("hello") == 0);
+    REQUIRE(!map.contains("hello"));
+    REQUIRE(map.size() == 4);
+
+    auto map2 = map;
+    REQUIRE(map2 == map);
+    REQUIRE(map2.key_bytes() == map.key_bytes() - 5);
+    for (auto const& [key, val] : map2) {
+        REQUIRE(map.at(key) == val);
+        if (!key.empty()) {
+            REQUIRE(key.data() != map.find(key)->first.data());
+        }
+    }
+
+    auto map3 = std::move(map2);
+    REQUIRE(map3 == map);
+    REQUIRE(map2.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    map2["x"] = 1;
+    REQUIRE(map2.size() == 1);
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(map.key_bytes() == 0);
+    REQUIRE(map.try_emplace("again", 1).second);
+}
+
+TEST_CASE("string_map_compaction") {
+    static constexpr size_t num_keys = 1000;
+    auto map = map_t();
+    for (size_t i = 0; i < num_keys; ++i) {
+        map["key_" + std::to_string(i)] = i;
+    }
+    auto const full_bytes = map.key_bytes();
+
+    // erase all even keys, that's garbage until the next rehash
+    for (size_t i = 0; i < num_keys; i += 2) {
+        REQUIRE(map.erase("key_" + std::to_string(i)) == 1);
+    }
+    REQUIRE(map.key_bytes() == full_bytes);
+
+    map.shrink_to_fit();
+    REQUIRE(map.key_bytes() < full_bytes);
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto it = map.find("key_" + std::to_string(i));
+        REQUIRE((it != map.end()) == (i % 2 == 1));
+        if (it != map.end()) {
+            REQUIRE(it->second == i);
+        }
+    }
+
+    // growing the map compacts the garbage too
+    auto const bytes_after_shrink = map.key_bytes();
+    REQUIRE(map.erase("key_1") == 1);
+    auto const buckets = map.bucket_count();
+    size_t i = num_keys;
+    while (map.bucket_count() == buckets) {
+        map["key_" + std::to_string(i)] = i;
+        ++i;
+    }
+    auto added_bytes = size_t();
+    for (size_t j = num_keys; j < i; ++j) {
+        added_bytes += ("key_" + std::to_string(j)).size();
+    }
+    REQUIRE(map.key_bytes() == bytes_after_shrink - 5 + added_bytes);
+    REQUIRE(map.at("key_999") == 999);
+    REQUIRE(!map.contains("key_1"));
+}
+
+TEST_CASE("string_map_counter") {
+    auto counts = counter();
+    INFO(counts);
+    {
+        auto map = ankerl::unordered_dense::string_map<counter::obj>();
+        for (size_t i = 0; i < 100; ++i) {
+            map.try_emplace(std::to_string(i), i, counts);
+        }
+        for (size_t i = 0; i < 100; i += 3) {
+            REQUIRE(map.erase(std::to_string(i)) == 1);
+        }
+        map.shrink_to_fit();
+        auto map2 = map;
+        REQUIRE(map2.size() == 66);
+        map = std::move(map2);
+        REQUIRE(map.size() == 66);
+        map.swap(map2);
+        REQUIRE(map2.size() == 66);
+        REQUIRE(map2.at("98").get() == 98);
+    }
+    REQUIRE(counts.ctor() + counts.default_ctor() + counts.copy_ctor() + counts.move_ctor() == counts.dtor());
+}
+
+namespace {
+
+struct counting_hash {
+    using is_avalanching = void;
+
+    static inline size_t num_calls = 0;
+
+    auto operator()(std::string_view str) const noexcept -> uint64_t {
+        ++num_calls;
+        return ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+};
+
+struct throws_on_negative {
+    int m_value;
+
+    explicit throws_on_negative(int value)
+        : m_value(value) {
+        if (value < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("string_map_hashes_once") {
+    auto map = ankerl::unordered_dense::string_map<size_t, counting_hash>();
+    map.reserve(100);
+
+    counting_hash::num_calls = 0;
+    REQUIRE(map.try_emplace("hello", 1).second);
+    REQUIRE(counting_hash::num_calls == 1);
+    REQUIRE(!map.try_emplace("hello", 2).second);
+    REQUIRE(counting_hash::num_calls == 2);
+    map["world"] = 3;
+    REQUIRE(counting_hash::num_calls == 3);
+    REQUIRE(map.insert_or_assign("world", 4).second == false);
+    REQUIRE(counting_hash::num_calls == 4);
+    REQUIRE(map.at("world") == 4);
+}
+
+TEST_CASE("string_map_throwing_value") {
+    auto map = ankerl::unordered_dense::string_map<throws_on_negative>();
+    REQUIRE(map.try_emplace("a", 1).second);
+    REQUIRE_THROWS_AS(map.try_emplace("bb", -1), std::runtime_error);
+    REQUIRE(map.size() == 1);
+    REQUIRE(!map.contains("bb"));
+    REQUIRE(map.key_bytes() == 1);
+
+    // the characters of "bb" were given back, so "cc" directly follows "a"
+    REQUIRE(map.try_emplace("cc", 2).second);
+    REQUIRE(map.find("cc")->first.data() == map.find("a")->first.data() + 1);
+}